@@ -0,0 +1,148 @@
+// AllocationCounter.cpp
+#include "AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+    #include <malloc.h>
+#endif
+
+#ifndef SEVENS_COUNT_ALLOCATIONS
+#error "AllocationCounter.cpp replaces the global operator new: only link it into builds defining SEVENS_COUNT_ALLOCATIONS"
+#endif
+
+namespace sevens {
+namespace allocations {
+
+static thread_local uint64_t threadCount = 0;
+
+uint64_t count() {
+    return threadCount;
+}
+
+static void* allocate(std::size_t size) {
+    threadCount++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+static void* allocateNoThrow(std::size_t size) noexcept {
+    threadCount++;
+    return std::malloc(size ? size : 1);
+}
+
+// Over-aligned types (alignas above the default new alignment)
+static void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept {
+    threadCount++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc wants a non-zero multiple of the alignment
+    std::size_t rounded = size ? (size + align - 1) / align * align : align;
+    return std::aligned_alloc(align, rounded);
+#endif
+}
+
+static void* allocateAlignedOrThrow(std::size_t size, std::align_val_t alignment) {
+    void* p = allocateAligned(size, alignment);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+static void freeAligned(void* p) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace allocations
+} // namespace sevens
+
+// Replacement global allocation functions (counting, malloc-backed)
+void* operator new(std::size_t size) {
+    return sevens::allocations::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return sevens::allocations::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return sevens::allocations::allocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return sevens::allocations::allocateNoThrow(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return sevens::allocations::allocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return sevens::allocations::allocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return sevens::allocations::allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return sevens::allocations::allocateAligned(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    sevens::allocations::freeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    sevens::allocations::freeAligned(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    sevens::allocations::freeAligned(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    sevens::allocations::freeAligned(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    sevens::allocations::freeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    sevens::allocations::freeAligned(p);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sevens {
+
+/**
+ * Counts heap allocations made through the global operator new.
+ * Counting is a measurement tool: it is only built with
+ * SEVENS_COUNT_ALLOCATIONS defined (sevens_bench), and then
+ * AllocationCounter.cpp, which replaces the global allocation functions,
+ * must be linked into the executable. Other builds keep the standard
+ * allocator, which dynamically loaded strategies share, and count()
+ * is always 0. Counts are per thread so parallel workers can each
+ * measure their own loop.
+ */
+namespace allocations {
+
+#ifdef SEVENS_COUNT_ALLOCATIONS
+constexpr bool ENABLED = true;
+
+// Allocations made by the calling thread since it started
+uint64_t count();
+#else
+constexpr bool ENABLED = false;
+
+inline uint64_t count() {
+    return 0;
+}
+#endif
+
+} // namespace allocations
+
+} // namespace sevens
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include "LegalMoves.hpp"
+#include "PlayerStrategyV2.hpp"
+#include <cstdint>
+
+namespace sevens {
+
+/**
+ * What the other seats cannot be holding, inferred from the round so far.
+ *
+ * A seat only passes when it has no legal card, so on a pass every card
+ * that was playable at that moment is ruled out for that seat for the
+ * rest of the round. Cards on the table are ruled out for everyone.
+ * Every event costs a couple of mask operations.
+ *
+ * Strategies feed it from observeMove/observePass and call sync() with
+ * the GameView at each of their turns. Moves and passes are not tagged
+ * with a round, so the last few events are kept in a small ring. When
+ * the view shows that a new round has started since the previous sync
+ * (fewer turns taken than events seen), the tracker starts over and
+ * replays the events that belong to the new round.
+ */
+class BeliefTracker {
+public:
+    static constexpr int MAX_SEATS = GameView::MAX_SEATS;
+
+    BeliefTracker() {
+        reset(STARTING_TABLE);
+    }
+
+    void observeMove(uint64_t seat, const Card& card) {
+        int bit = bitboard::cardBit(card.suit, card.rank);
+        record(seat, bit);
+        table |= CardMask(1) << bit;
+    }
+
+    void observePass(uint64_t seat) {
+        record(seat, PASS);
+        if (seat < MAX_SEATS) {
+            excluded[seat] |= moves::playableCards(table);
+        }
+    }
+
+    // Line the tracker up with the view at our turn
+    void sync(const GameView& view) {
+        // Our own previous turn is not among the events
+        bool newRound = !synced || view.turn < pending + 1 || (table & ~view.table) != 0;
+        if (newRound) {
+            int replay = view.turn <= pending ? view.turn : 0;
+            if (replay > RING_SIZE) {
+                replay = 0;
+            }
+            restart(replay);
+        }
+        table |= view.table;
+        pending = 0;
+        synced = true;
+    }
+
+    // Version 1 interface: only the table is known, so a table that lost
+    // cards means a new round, which starts without any inference
+    void syncTable(CardMask currentTable) {
+        if (table & ~currentTable) {
+            reset(currentTable);
+        }
+        table |= currentTable;
+        pending = 0;
+    }
+
+    // Cards `seat` cannot be holding (the table included)
+    CardMask cannotHold(int seat) const {
+        return (seat < MAX_SEATS ? excluded[seat] : 0) | table;
+    }
+
+    // The cards of `unseen` that `seat` might be holding
+    CardMask possibleCards(int seat, CardMask unseen) const {
+        return unseen & ~cannotHold(seat);
+    }
+
+    // Passes have ruled out some card for `seat`
+    bool constrains(int seat) const {
+        return seat < MAX_SEATS && excluded[seat] != 0;
+    }
+
+    void reset(CardMask startingTable) {
+        for (CardMask& mask : excluded) {
+            mask = 0;
+        }
+        table = startingTable;
+    }
+
+private:
+    static constexpr CardMask STARTING_TABLE = bitboard::cardMask(1, 7);   // the 7 of Diamonds
+    static constexpr uint8_t PASS = 0xFF;
+    static constexpr int RING_SIZE = 2 * MAX_SEATS;
+
+    struct Event {
+        uint8_t seat;
+        uint8_t bit;   // card played, or PASS
+    };
+
+    CardMask excluded[MAX_SEATS];
+    CardMask table;
+    Event ring[RING_SIZE] = {};
+    int next = 0;        // ring slot of the next event
+    int pending = 0;     // events since the last sync
+    bool synced = false;
+
+    void record(uint64_t seat, int bit) {
+        ring[next] = Event{static_cast<uint8_t>(seat < MAX_SEATS ? seat : 0xFF), static_cast<uint8_t>(bit)};
+        next = next + 1 == RING_SIZE ? 0 : next + 1;
+        pending++;
+    }
+
+    // Start the round over and apply its first `count` events again (the
+    // last `count` recorded)
+    void restart(int count) {
+        reset(STARTING_TABLE);
+        int slot = (next - count + RING_SIZE) % RING_SIZE;
+        for (int i = 0; i < count; i++) {
+            const Event& event = ring[slot];
+            if (event.bit == PASS) {
+                if (event.seat < MAX_SEATS) {
+                    excluded[event.seat] |= moves::playableCards(table);
+                }
+            } else {
+                table |= CardMask(1) << event.bit;
+            }
+            slot = slot + 1 == RING_SIZE ? 0 : slot + 1;
+        }
+    }
+};
+
+} // namespace sevens
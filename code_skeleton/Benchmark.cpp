@@ -0,0 +1,1085 @@
+// Benchmark.cpp
+// Microbenchmarks for the engine and strategy hot paths (sevens_bench).
+//
+// Usage: ./sevens_bench [positions] [seed]
+//        ./sevens_bench verify [positions] [seed]
+//
+// Every case reports ns/op and heap allocations/op (AllocationCounter);
+// whole games also report games/sec. Strategy cases run over a corpus of
+// positions generated by random playouts from the given seed, so two runs
+// with the same arguments time exactly the same work. `verify` instead
+// checks the FYM_Quest lookup tables against the original map-based
+// simulations they replace
+// (and the other exact shortcuts: the belief tracker and the endgame
+// solver, against a plain minimax), and that game records decode to the
+// games logged.
+#include "MyGameMapper.hpp"
+#include "RandomStrategy.hpp"
+#include "GreedyStrategy.hpp"
+#include "FYM_Quest.hpp"
+#include "FYM_SuitTables.hpp"
+#include "FYM_TranspositionCache.hpp"
+#include "GameState.hpp"
+#include "EndgameSolver.hpp"
+#include "BeliefTracker.hpp"
+#include "DealSampler.hpp"
+#include "GameRecord.hpp"
+#include "PIMCStrategy.hpp"
+#include "ISMCTSStrategy.hpp"
+#include "AllocationCounter.hpp"
+#include "Bitboard.hpp"
+#include "LegalMoves.hpp"
+#include "RngStream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * One position of the corpus, in both the version 2 form (GameView) and
+ * the version 1 form (hand vector and nested-map table layout).
+ */
+struct BenchPosition {
+    GameView view;
+    std::vector<Card> hand;
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> layout;
+};
+
+/**
+ * A position seen by one seat, with what that seat has inferred from the
+ * passes so far.
+ */
+struct BeliefPosition {
+    GameView view;
+    BeliefTracker beliefs;
+};
+
+/**
+ * Accumulates time and allocations over the timed sections of a case.
+ */
+class Stopwatch {
+public:
+    void start() {
+        startAllocations = allocations::count();
+        startTime = std::chrono::steady_clock::now();
+    }
+
+    void stop() {
+        auto now = std::chrono::steady_clock::now();
+        seconds += std::chrono::duration<double>(now - startTime).count();
+        allocated += allocations::count() - startAllocations;
+    }
+
+    double seconds = 0.0;
+    uint64_t allocated = 0;
+
+private:
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t startAllocations = 0;
+};
+
+/**
+ * Runs the cases and prints one line per case. Friend of MyGameMapper so
+ * the round steps (dealCards, playRound, isPlayable) can be timed on
+ * their own.
+ */
+class EngineBenchmark {
+public:
+    EngineBenchmark(uint64_t numPositions, uint64_t seed) : seed(seed) {
+        engine.read_cards("cards.txt");
+        engine.read_game("");
+        generateCorpus(numPositions);
+    }
+
+    void run() {
+        std::cout << "\n=================================\n";
+        std::cout << "BENCHMARK RESULTS (" << corpus.size() << " positions, seed " << seed << ")\n";
+        std::cout << "=================================\n";
+        std::cout << std::left << std::setw(36) << "case"
+                  << std::right << std::setw(14) << "ns/op"
+                  << std::setw(14) << "allocs/op" << "\n";
+
+        benchIsPlayable();
+        benchDealCards();
+        benchPlayRound();
+
+        benchGames("runMultipleRounds 4x Random", 2000, [] { return std::make_shared<RandomStrategy>(); });
+        benchGames("runMultipleRounds 4x Greedy", 2000, [] { return std::make_shared<GreedyStrategy>(); });
+        benchGames("runMultipleRounds 4x FYM_Quest", 100, [] { return std::make_shared<FYM_Quest>(); });
+
+        benchStrategy(std::make_shared<RandomStrategy>());
+        benchStrategy(std::make_shared<GreedyStrategy>());
+        benchStrategy(std::make_shared<FYM_Quest>());
+        benchCachedFYM();
+
+        benchEndgame(1);
+        unsigned cores = std::thread::hardware_concurrency();
+        if (cores > 1) {
+            benchEndgame(cores);
+        }
+
+        benchPIMC(1);
+        if (cores > 1) {
+            benchPIMC(cores);
+        }
+        benchISMCTS();
+        benchDealSampler();
+    }
+
+    // Deals drawn where passes rule out cards, with DealSampler and with
+    // plain shuffle-and-reject for comparison
+    void benchDealSampler() {
+        std::vector<BeliefPosition> positions = beliefPositions();
+        const int draws = 64;
+        RngStream rng = RngStream(seed).derive(corpus.size() + 6);
+
+        DealStats stats;
+        CardMask checksum = 0;
+        Stopwatch watch;
+        watch.start();
+        for (const BeliefPosition& position : positions) {
+            DealSampler sampler(position.view, &position.beliefs);
+            for (int draw = 0; draw < draws; draw++) {
+                checksum ^= sampler.sample(rng, &stats).hands[0];
+            }
+        }
+        watch.stop();
+        report("DealSampler::sample constrained", stats.samples, watch);
+        printDealStats(stats, watch);
+
+        // Reference: shuffle the unseen cards until no seat gets a card it
+        // cannot hold (at most 100000 shuffles)
+        DealStats naive;
+        Stopwatch naiveWatch;
+        naiveWatch.start();
+        for (const BeliefPosition& position : positions) {
+            const GameView& view = position.view;
+            int unseen[52];
+            int count = 0;
+            bitboard::forEachCard(bitboard::FULL_DECK & ~view.table & ~view.hand, [&](int bit) {
+                unseen[count++] = bit;
+            });
+            for (int draw = 0; draw < draws; draw++) {
+                bool consistent = false;
+                for (int attempt = 0; attempt < 100000 && !consistent; attempt++) {
+                    naive.attempts++;
+                    rng.shuffle(unseen, unseen + count);
+                    consistent = true;
+                    int next = 0;
+                    for (int seat = 0; seat < view.numPlayers; seat++) {
+                        if (seat == view.seat) continue;
+                        CardMask hand = 0;
+                        for (int n = 0; n < view.handCounts[seat]; n++) {
+                            hand |= CardMask(1) << unseen[next++];
+                        }
+                        consistent = consistent && (hand & position.beliefs.cannotHold(seat)) == 0;
+                        checksum ^= hand;
+                    }
+                }
+                naive.samples++;
+                naive.fallbacks += !consistent;
+            }
+        }
+        naiveWatch.stop();
+        report("shuffle-and-reject constrained", naive.samples, naiveWatch);
+        printDealStats(naive, naiveWatch);
+        if (checksum == 1) std::cout << "(checksum " << checksum << ")\n";
+    }
+
+    static void printDealStats(const DealStats& stats, const Stopwatch& watch) {
+        std::cout << "    " << std::setprecision(0) << (watch.seconds > 0 ? stats.samples / watch.seconds : 0.0)
+                  << " samples/s, " << std::setprecision(1) << 100.0 * stats.rejectionRate()
+                  << "% of attempts rejected, " << stats.fallbacks << " gave up\n";
+    }
+
+    // ISMCTSStrategy with its default settings on a slice of the corpus
+    void benchISMCTS() {
+        auto strategy = std::make_shared<ISMCTSStrategy>(ISMCTSConfig());
+        strategy->seedRandom(RngStream(seed));
+
+        size_t count = std::max<size_t>(1, corpus.size() / 16);
+        int checksum = 0;
+        Stopwatch watch;
+        watch.start();
+        for (size_t i = 0; i < count; i++) {
+            strategy->initialize(corpus[i].view.seat);
+            checksum += strategy->selectCard(corpus[i].view);
+        }
+        watch.stop();
+
+        report("ISMCTSStrategy::selectCard", count, watch);
+        const ISMCTSStats& stats = strategy->stats();
+        double seconds = stats.seconds > 0 ? stats.seconds : 1.0;
+        std::cout << "    " << stats.decisions << " decisions, " << std::setprecision(0)
+                  << stats.iterations / seconds << " iterations/s, " << stats.nodes / seconds << " nodes/s, peak "
+                  << stats.peakNodes << " nodes (" << std::setprecision(1)
+                  << stats.peakNodes * (strategy->arenaBytes() / strategy->config().arenaNodes) / 1024.0
+                  << " KiB of a " << strategy->arenaBytes() / 1024.0 << " KiB arena)\n";
+        if (checksum == INT32_MIN) std::cout << "(checksum " << checksum << ")\n";
+    }
+
+    // PIMCStrategy with its default settings on a slice of the corpus
+    void benchPIMC(unsigned threads) {
+        PIMCConfig config;
+        config.threads = threads;
+        auto strategy = std::make_shared<PIMCStrategy>(config);
+        strategy->seedRandom(RngStream(seed));
+
+        size_t count = std::max<size_t>(1, corpus.size() / 16);
+        int checksum = 0;
+        Stopwatch watch;
+        watch.start();
+        for (size_t i = 0; i < count; i++) {
+            strategy->initialize(corpus[i].view.seat);
+            checksum += strategy->selectCard(corpus[i].view);
+        }
+        watch.stop();
+
+        report("PIMCStrategy::selectCard " + std::to_string(threads) + "t", count, watch);
+        const PIMCStats& stats = strategy->stats();
+        std::cout << "    " << stats.decisions << " decisions, "
+                  << (stats.decisions ? stats.rollouts / stats.decisions : 0) << " rollouts and "
+                  << std::setprecision(1) << (stats.rollouts ? 1e9 * stats.seconds / stats.rollouts : 0.0)
+                  << " ns per rollout\n";
+        if (checksum == INT32_MIN) std::cout << "(checksum " << checksum << ")\n";
+    }
+
+    // FYM_Quest deciding 4-player endgames (at most 16 cards left in all
+    // hands, at least two legal moves) with the endgame solver
+    void benchEndgame(unsigned threads) {
+        const int maxCards = 16;
+        std::vector<GameView> endgames = endgamePositions(std::max<size_t>(1, corpus.size() / 16), maxCards);
+
+        EndgameConfig config;
+        config.maxCards = maxCards;
+        config.threads = threads;
+        auto strategy = std::make_shared<FYM_Quest>();
+        strategy->setEndgameConfig(config);
+        strategy->seedRandom(RngStream(seed));
+
+        int checksum = 0;
+        Stopwatch watch;
+        watch.start();
+        for (const GameView& view : endgames) {
+            strategy->initialize(view.seat);
+            checksum += strategy->selectCard(view);
+        }
+        watch.stop();
+
+        report("FYM_Quest::selectCard endgame " + std::to_string(threads) + "t", endgames.size(), watch);
+        const EndgameStats& stats = *strategy->endgameStats();
+        uint64_t searched = stats.solves + stats.aborted;
+        std::cout << "    " << stats.solves << " solved, " << stats.aborted << " out of nodes, "
+                  << (searched ? stats.nodes / searched : 0) << " nodes and "
+                  << std::setprecision(1) << (searched ? 1e6 * stats.seconds / searched : 0.0)
+                  << " us per search\n";
+        if (checksum == INT32_MIN) std::cout << "(checksum " << checksum << ")\n";
+    }
+
+    // FYM_Quest with a private cache: a cold pass over the corpus, then a
+    // warm one where every position is a hit
+    void benchCachedFYM() {
+        fym::TranspositionCache cache(uint64_t(1) << 16);
+        auto strategy = std::make_shared<FYM_Quest>();
+        strategy->setTranspositionCache(&cache);
+        strategy->seedRandom(RngStream(seed));
+
+        int checksum = 0;
+        for (const char* pass : {"cold", "warm"}) {
+            Stopwatch watch;
+            watch.start();
+            for (const BenchPosition& position : corpus) {
+                strategy->initialize(position.view.seat);
+                checksum += strategy->selectCard(position.view);
+            }
+            watch.stop();
+            report(std::string("FYM_Quest::selectCard cached ") + pass, corpus.size(), watch);
+        }
+
+        strategy->setTranspositionCache(nullptr);
+        std::cout << "    cache " << cache.size() << " entries, " << cache.hits() << " hits, "
+                  << cache.misses() << " misses\n";
+        if (checksum == INT32_MIN) std::cout << "(checksum " << checksum << ")\n";
+    }
+
+    // Compare the table lookups with the original map-based simulations on
+    // every corpus position, every position one legal move later, and as
+    // many positions with arbitrary table intervals and hands. Returns the
+    // mismatches.
+    uint64_t verify() {
+        std::vector<std::pair<CardMask, CardMask>> positions; // (hand, table)
+        for (const BenchPosition& position : corpus) {
+            CardMask hand = position.view.hand;
+            CardMask table = position.view.table;
+            positions.push_back({hand, table});
+            bitboard::forEachCard(moves::legalMoves(hand, table), [&](int bit) {
+                CardMask card = CardMask(1) << bit;
+                positions.push_back({hand & ~card, table | card});
+            });
+        }
+
+        RngStream rng = RngStream(seed).derive(corpus.size() + 1);
+        for (size_t i = 0; i < corpus.size(); i++) {
+            CardMask table = 0;
+            for (int suit = 0; suit < 4; suit++) {
+                if (rng.below(4) == 0) continue; // nothing of this suit yet
+                int lo = 1 + rng.below(7);
+                int hi = 7 + rng.below(7);
+                for (int rank = lo; rank <= hi; rank++) {
+                    table |= bitboard::cardMask(suit, rank);
+                }
+            }
+            CardMask hand = rng() & bitboard::FULL_DECK & ~table;
+            positions.push_back({hand, table});
+        }
+
+        // Every card of the hand the original FYM_Quest would have scored,
+        // with its map-based simulation as the reference
+        std::vector<Card> cards;
+        std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> layout;
+        CardMask mirrored = 0;
+        uint64_t moves = 0;
+        uint64_t mismatches = 0;
+        for (const auto& position : positions) {
+            CardMask hand = position.first;
+            CardMask table = position.second;
+            bitboard::toCards(hand, cards);
+            bitboard::syncTableLayout(table, mirrored, layout);
+            for (int i = 0; i < static_cast<int>(cards.size()); i++) {
+                bool playable = referenceIsPlayable(cards[i], layout);
+                if (playable != moves::isLegalMove(cards[i], table)) {
+                    if (mismatches < 10) {
+                        std::cout << std::hex << "hand 0x" << hand << " table 0x" << table << std::dec
+                                  << ": card " << cards[i].suit << "/" << cards[i].rank
+                                  << (playable ? " only" : " not") << " playable in the map layout\n";
+                    }
+                    mismatches++;
+                }
+                if (!playable) continue;
+
+                // FYM_Quest::analyzeSequence and countFuturePlays after the move
+                CardMask card = bitboard::cardMask(cards[i]);
+                int sequence = 1 + fym::sequenceLength(hand & ~card, table | card);
+                int sequenceReference = referenceSequence(i, cards, layout);
+                int future = fym::playableCount(hand & ~card, table | card);
+                int futureReference = referenceFuturePlays(i, cards, layout);
+                if (sequence != sequenceReference || future != futureReference) {
+                    if (mismatches < 10) {
+                        std::cout << std::hex << "hand 0x" << hand << " table 0x" << table << std::dec
+                                  << ": card " << cards[i].suit << "/" << cards[i].rank
+                                  << " sequence " << sequence << " vs " << sequenceReference
+                                  << ", future plays " << future << " vs " << futureReference << "\n";
+                    }
+                    mismatches++;
+                }
+                moves++;
+            }
+        }
+
+        std::cout << "Checked " << moves << " moves in " << positions.size()
+                  << " positions against the map-based simulation: " << mismatches << " mismatches\n";
+        return mismatches + verifyBeliefs() + verifyDealSampler() + verifyEndgameSolver()
+             + verifyRecords();
+    }
+
+    // EndgameSolver with one sample against a plain minimax of the deal it
+    // draws, on 8- and 10-card endgames. One solver keeps its table over all
+    // the positions, so bounds stored by earlier decisions are reused, one
+    // starts empty and one searches on two threads. The shared one also
+    // evaluates every position of a playout of each deal, since a wrong
+    // bound rarely changes the move of such small endgames. On 16-card endgames
+    // searched over 8 deals, big enough to count batches of nodes, a solver
+    // must then finish within the nodes it reported, and run out of nodes
+    // when the budget is below the last full batch.
+    uint64_t verifyEndgameSolver() {
+        const uint64_t nodeBatch = 1024;   // nodes a search thread counts before checking the budget
+
+        EndgameConfig config;
+        config.maxCards = 16;
+        config.samples = 1;
+        config.nodeBudget = UINT64_MAX / 2;
+        config.tableEntries = 1 << 12;
+        EndgameSolver shared(config);
+        EndgameConfig twoThreads = config;
+        twoThreads.threads = 2;
+        EndgameSolver parallel(twoThreads);
+
+        uint64_t checked = 0;
+        uint64_t mismatches = 0;
+        uint64_t values = 0;
+        uint64_t valueMismatches = 0;
+        size_t count = std::max<size_t>(1, corpus.size() / 32);
+        auto solveWith = [](EndgameSolver& solver, const GameView& view, const RngStream& rng) {
+            RngStream copy = rng;
+            return solver.solve(view, copy);
+        };
+
+        for (int maxCards : {8, 10}) {
+            for (const GameView& view : endgamePositions(count, maxCards)) {
+                // Every solve draws the same deal from a copy of this stream
+                const RngStream rng = RngStream(seed).derive(corpus.size() + 7, checked++);
+                RngStream stream = rng;
+                GameState deal = DealSampler(view).sample(stream);
+                int expected = minimaxMove(deal, view.seat);
+
+                EndgameSolver fresh(config);
+                mismatches += solveWith(shared, view, rng) != expected || solveWith(fresh, view, rng) != expected
+                           || solveWith(parallel, view, rng) != expected;
+
+                // The searched values, for every seat, along a random
+                // playout of the deal
+                GameState state = deal;
+                int passes = 0;
+                while (passes < state.numPlayers) {
+                    for (int seat = 0; seat < state.numPlayers; seat++) {
+                        values++;
+                        valueMismatches += shared.evaluate(state, seat) != minimaxValue(state, seat);
+                    }
+                    int mover = state.toMove;
+                    CardMask legal = state.legalMoves();
+                    if (!legal) {
+                        state.pass();
+                        passes++;
+                        continue;
+                    }
+                    state.makeMove(GameState::randomCard(legal, stream));
+                    passes = 0;
+                    if (state.hands[mover] == 0) break;
+                }
+            }
+        }
+
+        EndgameConfig sampled = config;
+        sampled.samples = 8;
+        uint64_t budgets = 0;
+        uint64_t budgetMismatches = 0;
+        uint64_t drawn = 0;
+        for (const GameView& view : endgamePositions(count, 16)) {
+            const RngStream rng = RngStream(seed).derive(corpus.size() + 8, drawn++);
+            EndgameSolver fresh(sampled);
+            int expected = solveWith(fresh, view, rng);
+            uint64_t nodes = fresh.stats().nodes;
+            if (nodes < nodeBatch) continue;
+            budgets++;
+
+            EndgameConfig exact = sampled;
+            exact.nodeBudget = nodes;
+            EndgameSolver enough(exact);
+            EndgameConfig tight = sampled;
+            tight.nodeBudget = nodes / nodeBatch * nodeBatch - 1;
+            EndgameSolver starved(tight);
+            budgetMismatches += solveWith(enough, view, rng) != expected || solveWith(starved, view, rng) != -1
+                             || starved.stats().aborted != 1;
+        }
+
+        std::cout << "Checked " << checked << " endgames against minimax: " << mismatches << " mismatches, "
+                  << valueMismatches << " of " << values << " values wrong\n";
+        std::cout << "Checked " << budgets << " endgame node budgets: " << budgetMismatches << " mismatches\n";
+        return mismatches + valueMismatches + budgetMismatches;
+    }
+
+    // Games of random play logged with GameRecorder, 2 to 7 seats and one
+    // game in four with cards missing from the deck: encodeRecord then
+    // decodeGame must give back every hand dealt and every card played.
+    // In one game in four the seats pass 255 times out of 256 while
+    // holding a legal card, which the engine allows, so that the log
+    // outgrows the recorder's first buffer
+    uint64_t verifyRecords() {
+        RngStream rng = RngStream(seed).derive(corpus.size() + 9);
+        GameRecorder recorder;
+        std::vector<uint8_t> record;
+        RecordedGame decoded;
+        std::vector<int> deck;
+        uint64_t games = std::max<size_t>(1, corpus.size() / 16);
+        uint64_t mismatches = 0;
+        uint64_t longest = 0;
+
+        for (uint64_t game = 0; game < games; game++) {
+            bool stalling = rng.below(4) == 0;
+            RecordedGame expected;
+            expected.numSeats = 2 + rng.below(6);
+            expected.deck = records::STANDARD_DECK;
+            if (rng.below(4) == 0) {
+                expected.deck &= ~(rng() & rng());
+            }
+            deck.clear();
+            bitboard::forEachCard(expected.deck, [&](int bit) { deck.push_back(bit); });
+
+            recorder.beginGame(expected.numSeats);
+            for (uint32_t round = 1 + rng.below(4); round > 0; round--) {
+                rng.shuffle(deck.begin(), deck.end());
+                RecordedRound played;
+                played.hands.assign(expected.numSeats, 0);
+                for (size_t i = 0; i < deck.size(); i++) {
+                    played.hands[i % expected.numSeats] |= CardMask(1) << deck[i];
+                }
+                recorder.beginRound(played.hands);
+
+                GameState state;
+                state.numPlayers = static_cast<int>(expected.numSeats);
+                state.table = bitboard::cardMask(1, 7);
+                std::copy(played.hands.begin(), played.hands.end(), state.hands.begin());
+                int passes = 0;
+                while (passes < state.numPlayers) {
+                    int seat = state.toMove;
+                    CardMask legal = state.legalMoves();
+                    if (!legal || (stalling && rng.below(256) != 0)) {
+                        state.pass();
+                        recorder.pass();
+                        played.moves.push_back(records::PASS);
+                        // Only passes without a legal card end the round
+                        passes = legal ? 0 : passes + 1;
+                        continue;
+                    }
+                    int bit = GameState::randomCard(legal, rng);
+                    state.makeMove(bit);
+                    recorder.play(bit);
+                    played.moves.push_back(static_cast<uint8_t>(bit));
+                    passes = 0;
+                    if (state.hands[seat] == 0) break;
+                }
+                recorder.endRound();
+                expected.rounds.push_back(std::move(played));
+            }
+
+            longest = std::max<uint64_t>(longest, recorder.size());
+            record.clear();
+            bool ok = encodeRecord(recorder.data(), recorder.size(), record)
+                   && decodeGame(record.data(), record.size(), decoded)
+                   && decoded.numSeats == expected.numSeats && decoded.deck == expected.deck
+                   && decoded.rounds.size() == expected.rounds.size();
+            for (size_t r = 0; ok && r < expected.rounds.size(); r++) {
+                ok = decoded.rounds[r].hands == expected.rounds[r].hands
+                  && decoded.rounds[r].moves == expected.rounds[r].moves;
+            }
+            mismatches += !ok;
+        }
+
+        std::cout << "Checked " << games << " recorded games: " << mismatches << " mismatches (longest log "
+                  << longest << " bytes)\n";
+        return mismatches;
+    }
+
+    // At every turn of one seat, none of the cards its BeliefTracker rules
+    // out may be in the hand that really holds them
+    uint64_t verifyBeliefs() {
+        RngStream rng = RngStream(seed).derive(corpus.size() + 3);
+        uint64_t checks = 0;
+        uint64_t violations = 0;
+        uint64_t inferred = 0;
+
+        int rounds = static_cast<int>(std::max<size_t>(1, corpus.size() / 16));
+        playObservedRounds(rng, rounds, [&](const GameState& state, const GameView& view, const BeliefTracker& tracker) {
+            for (int other = 0; other < state.numPlayers; other++) {
+                if (other == view.seat) continue;
+                checks++;
+                violations += (state.hands[other] & tracker.cannotHold(other)) != 0;
+                inferred += bitboard::popcount(tracker.cannotHold(other) & ~state.table & ~view.hand);
+            }
+        });
+
+        std::cout << "Checked " << checks << " belief states: " << violations << " ruled out a held card ("
+                  << std::setprecision(2) << std::fixed << (checks ? double(inferred) / checks : 0.0)
+                  << " unseen cards ruled out per seat on average)\n";
+        return violations;
+    }
+
+    // Every deal drawn by DealSampler must give each seat its number of
+    // cards, all the unseen cards and, unless it fell back, none of the
+    // cards the beliefs rule out
+    uint64_t verifyDealSampler() {
+        RngStream rng = RngStream(seed).derive(corpus.size() + 4);
+        uint64_t mismatches = 0;
+        DealStats stats;
+
+        for (const BeliefPosition& position : beliefPositions()) {
+            const GameView& view = position.view;
+            DealSampler sampler(view, &position.beliefs);
+            CardMask unseen = bitboard::FULL_DECK & ~view.table & ~view.hand;
+            for (int draw = 0; draw < 16; draw++) {
+                uint64_t fallbacks = stats.fallbacks;
+                GameState deal = sampler.sample(rng, &stats);
+                bool ok = deal.hands[view.seat] == view.hand && deal.table == view.table;
+                CardMask dealt = 0;
+                for (int seat = 0; seat < view.numPlayers; seat++) {
+                    if (seat == view.seat) continue;
+                    ok = ok && bitboard::popcount(deal.hands[seat]) == view.handCounts[seat]
+                            && (deal.hands[seat] & dealt) == 0;
+                    if (stats.fallbacks == fallbacks) {
+                        ok = ok && (deal.hands[seat] & position.beliefs.cannotHold(seat)) == 0;
+                    }
+                    dealt |= deal.hands[seat];
+                }
+                mismatches += !(ok && dealt == unseen);
+            }
+        }
+
+        std::cout << "Checked " << stats.samples << " constrained deals: " << mismatches << " mismatches ("
+                  << stats.fallbacks << " fell back)\n";
+        return mismatches;
+    }
+
+private:
+    static const uint64_t BENCH_PLAYERS = 4;
+
+    uint64_t seed;
+    MyGameMapper engine;
+    std::vector<BenchPosition> corpus;
+
+    static void report(const std::string& name, uint64_t ops, const Stopwatch& watch) {
+        double perOp = ops ? 1e9 * watch.seconds / ops : 0.0;
+        double allocsPerOp = ops ? static_cast<double>(watch.allocated) / ops : 0.0;
+        std::cout << std::left << std::setw(36) << name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(14) << perOp
+                  << std::setprecision(2) << std::setw(14) << allocsPerOp << "\n";
+    }
+
+    // A fresh 4-player round: the 7 of Diamonds on the table, the other
+    // cards dealt round-robin, seat 0 to move
+    static GameState randomDeal(RngStream& rng) {
+        const CardMask start = bitboard::cardMask(1, 7);
+        std::vector<int> deck;
+        bitboard::forEachCard(bitboard::FULL_DECK & ~start, [&](int bit) { deck.push_back(bit); });
+        rng.shuffle(deck.begin(), deck.end());
+
+        GameState state;
+        state.numPlayers = BENCH_PLAYERS;
+        state.table = start;
+        for (size_t i = 0; i < deck.size(); i++) {
+            state.hands[i % BENCH_PLAYERS] |= CardMask(1) << deck[i];
+        }
+        return state;
+    }
+
+    // Rounds played back to back at random, each seat in turn watching
+    // them through its own BeliefTracker. visit(state, view, tracker) is
+    // called at every turn of the watching seat, after the sync.
+    template <typename Visit>
+    static void playObservedRounds(RngStream& rng, int rounds, Visit&& visit) {
+        for (int observer = 0; observer < static_cast<int>(BENCH_PLAYERS); observer++) {
+            BeliefTracker tracker;
+            for (int round = 0; round < rounds; round++) {
+                GameState state = randomDeal(rng);
+                uint16_t turn = 0;
+                int passes = 0;
+                while (passes < state.numPlayers) {
+                    int seat = state.toMove;
+                    if (seat == observer) {
+                        GameView view = GameView{};
+                        view.hand = state.hands[seat];
+                        view.table = state.table;
+                        view.played = state.table & ~bitboard::cardMask(1, 7);
+                        view.turn = turn;
+                        view.seat = static_cast<uint8_t>(seat);
+                        view.numPlayers = static_cast<uint8_t>(state.numPlayers);
+                        for (int other = 0; other < state.numPlayers; other++) {
+                            view.handCounts[other] = static_cast<uint8_t>(state.cardsLeft(other));
+                        }
+                        tracker.sync(view);
+                        visit(state, view, tracker);
+                    }
+
+                    CardMask legal = state.legalMoves();
+                    turn++;
+                    if (!legal) {
+                        state.pass();
+                        passes++;
+                        if (seat != observer) tracker.observePass(seat);
+                        continue;
+                    }
+                    int bit = GameState::randomCard(legal, rng);
+                    state.makeMove(bit);
+                    passes = 0;
+                    if (seat != observer) tracker.observeMove(seat, bitboard::cardAt(bit));
+                    if (state.hands[seat] == 0) break;
+                }
+            }
+        }
+    }
+
+    // Positions where the watching seat's beliefs rule out some unseen card
+    std::vector<BeliefPosition> beliefPositions() {
+        RngStream rng = RngStream(seed).derive(corpus.size() + 5);
+        std::vector<BeliefPosition> positions;
+        int rounds = static_cast<int>(std::max<size_t>(1, corpus.size() / 16));
+        playObservedRounds(rng, rounds, [&](const GameState&, const GameView& view, const BeliefTracker& tracker) {
+            if (DealSampler(view, &tracker).constrained()) {
+                positions.push_back(BeliefPosition{view, tracker});
+            }
+        });
+        return positions;
+    }
+
+    // Value of state for `seat` without pruning or a table: minus the
+    // cards it holds at the end of the round, every other seat playing
+    // against it (the endgame solver's paranoid search)
+    static int minimaxValue(GameState& state, int seat) {
+        int mover = state.toMove;
+        CardMask legal = state.legalMoves();
+        if (!legal) {
+            if (state.blocked()) {
+                return -state.cardsLeft(seat);
+            }
+            state.pass();
+            int value = minimaxValue(state, seat);
+            state.unpass(mover);
+            return value;
+        }
+
+        int best = mover == seat ? INT32_MIN : INT32_MAX;
+        bitboard::forEachCard(legal, [&](int bit) {
+            state.makeMove(bit);
+            int value = state.hands[mover] == 0 ? -state.cardsLeft(seat) : minimaxValue(state, seat);
+            state.unmakeMove(bit, mover);
+            best = mover == seat ? std::max(best, value) : std::min(best, value);
+        });
+        return best;
+    }
+
+    // Best card of `seat` (to move) by minimaxValue, lowest card on ties
+    static int minimaxMove(GameState state, int seat) {
+        int bestMove = -1;
+        int bestValue = INT32_MIN;
+        bitboard::forEachCard(state.legalMoves(), [&](int bit) {
+            state.makeMove(bit);
+            int value = state.hands[seat] == 0 ? 0 : minimaxValue(state, seat);
+            state.unmakeMove(bit, seat);
+            if (value > bestValue) {
+                bestMove = bit;
+                bestValue = value;
+            }
+        });
+        return bestMove;
+    }
+
+    // The original FYM_Quest move simulations on the nested-map table
+    // layout, kept as the reference for the suit tables. Only the 7 of a
+    // suit or a card next to one on the table is playable.
+    static bool referenceIsPlayable(
+        const Card& card,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout)
+    {
+        int suit = card.suit;
+        int rank = card.rank;
+
+        if (rank == 7) {
+            return !(tableLayout.count(suit) > 0 &&
+                     tableLayout.at(suit).count(rank) > 0 &&
+                     tableLayout.at(suit).at(rank));
+        }
+
+        bool higherOnTable = (rank < 13 &&
+                              tableLayout.count(suit) > 0 &&
+                              tableLayout.at(suit).count(rank + 1) > 0 &&
+                              tableLayout.at(suit).at(rank + 1));
+        bool lowerOnTable = (rank > 1 &&
+                             tableLayout.count(suit) > 0 &&
+                             tableLayout.at(suit).count(rank - 1) > 0 &&
+                             tableLayout.at(suit).at(rank - 1));
+        return higherOnTable || lowerOnTable;
+    }
+
+    // Cards we could play in a row starting with hand[cardIdx], one play
+    // per step on a copy of the table
+    static int referenceSequence(
+        int cardIdx,
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout)
+    {
+        const Card& card = hand[cardIdx];
+        int maxLength = 1;
+        std::vector<bool> simulatedPlayed(hand.size(), false);
+        simulatedPlayed[cardIdx] = true;
+
+        auto simulatedTable = tableLayout;
+        simulatedTable[card.suit][card.rank] = true;
+
+        std::vector<bool> wouldBePlayable(hand.size(), false);
+        for (int i = 0; i < static_cast<int>(hand.size()); i++) {
+            if (i != cardIdx && !simulatedPlayed[i] &&
+                referenceIsPlayable(hand[i], simulatedTable)) {
+                wouldBePlayable[i] = true;
+            }
+        }
+
+        int currentLength = 1;
+        bool foundPlayable;
+        do {
+            foundPlayable = false;
+            for (int i = 0; i < static_cast<int>(hand.size()); i++) {
+                if (!simulatedPlayed[i] && wouldBePlayable[i]) {
+                    simulatedPlayed[i] = true;
+                    currentLength++;
+                    simulatedTable[hand[i].suit][hand[i].rank] = true;
+                    wouldBePlayable[i] = false;
+
+                    for (int j = 0; j < static_cast<int>(hand.size()); j++) {
+                        if (!simulatedPlayed[j] && !wouldBePlayable[j] &&
+                            referenceIsPlayable(hand[j], simulatedTable)) {
+                            wouldBePlayable[j] = true;
+                        }
+                    }
+
+                    foundPlayable = true;
+                    break; // one play per step
+                }
+            }
+            maxLength = std::max(maxLength, currentLength);
+        } while (foundPlayable);
+
+        return maxLength;
+    }
+
+    // Cards of the hand playable once hand[cardIdx] is on the table
+    static int referenceFuturePlays(
+        int cardIdx,
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout)
+    {
+        auto simulatedTable = tableLayout;
+        const Card& playedCard = hand[cardIdx];
+        simulatedTable[playedCard.suit][playedCard.rank] = true;
+
+        int count = 0;
+        for (int i = 0; i < static_cast<int>(hand.size()); i++) {
+            if (i != cardIdx && referenceIsPlayable(hand[i], simulatedTable)) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // 4-player positions reached by random play once at most maxCards are
+    // left in all hands, seen from a seat with a choice to make
+    std::vector<GameView> endgamePositions(size_t count, int maxCards) {
+        RngStream rng = RngStream(seed).derive(count, maxCards);
+        std::vector<GameView> positions;
+
+        const CardMask start = bitboard::cardMask(1, 7);
+
+        while (positions.size() < count) {
+            GameState state = randomDeal(rng);
+
+            // Random play until the position is small enough
+            uint16_t turn = 0;
+            bool finished = false;
+            while (!finished && bitboard::popcount(state.allHands()) > maxCards) {
+                int seat = state.toMove;
+                CardMask legal = state.legalMoves();
+                if (legal) {
+                    moves::PlayableList options = moves::toList(legal);
+                    state.makeMove(options[rng.below(options.size())]);
+                    finished = state.hands[seat] == 0;
+                } else {
+                    state.pass();
+                }
+                turn++;
+            }
+            if (finished || bitboard::popcount(state.legalMoves()) < 2) continue;
+
+            GameView view = GameView{};
+            view.hand = state.hands[state.toMove];
+            view.table = state.table;
+            view.played = state.table & ~start;
+            view.turn = turn;
+            view.seat = static_cast<uint8_t>(state.toMove);
+            view.numPlayers = static_cast<uint8_t>(state.numPlayers);
+            for (int seat = 0; seat < state.numPlayers; seat++) {
+                view.handCounts[seat] = static_cast<uint8_t>(state.cardsLeft(seat));
+            }
+            positions.push_back(view);
+        }
+        return positions;
+    }
+
+    // Positions reached by random play: 2 to 7 players, any number of turns
+    // into the round, seen from the seat about to move
+    void generateCorpus(uint64_t numPositions) {
+        RngStream rng = RngStream(seed).derive(numPositions);
+        const CardMask start = bitboard::cardMask(1, 7);
+
+        while (corpus.size() < numPositions) {
+            uint32_t numPlayers = 2 + rng.below(6);
+
+            std::vector<int> deck;
+            bitboard::forEachCard(bitboard::FULL_DECK & ~start, [&](int bit) { deck.push_back(bit); });
+            rng.shuffle(deck.begin(), deck.end());
+
+            std::vector<CardMask> hands(numPlayers, 0);
+            for (size_t i = 0; i < deck.size(); i++) {
+                hands[i % numPlayers] |= CardMask(1) << deck[i];
+            }
+
+            CardMask table = start;
+            uint32_t turns = rng.below(60);
+            uint32_t seat = 0;
+            for (uint32_t t = 0; t < turns; t++, seat = (seat + 1) % numPlayers) {
+                CardMask legal = moves::legalMoves(hands[seat], table);
+                if (legal) {
+                    moves::PlayableList options = moves::toList(legal);
+                    int bit = options[rng.below(options.size())];
+                    hands[seat] &= ~(CardMask(1) << bit);
+                    table |= CardMask(1) << bit;
+                }
+                if (!hands[seat]) break;
+            }
+            if (!hands[seat]) continue;
+
+            BenchPosition position;
+            position.view = GameView{};
+            position.view.hand = hands[seat];
+            position.view.table = table;
+            position.view.played = table & ~start;
+            position.view.turn = static_cast<uint16_t>(turns);
+            position.view.seat = static_cast<uint8_t>(seat);
+            position.view.numPlayers = static_cast<uint8_t>(numPlayers);
+            for (uint32_t p = 0; p < numPlayers; p++) {
+                position.view.handCounts[p] = static_cast<uint8_t>(bitboard::popcount(hands[p]));
+            }
+
+            bitboard::toCards(hands[seat], position.hand);
+            CardMask mirrored = 0;
+            bitboard::syncTableLayout(table, mirrored, position.layout);
+
+            corpus.push_back(std::move(position));
+        }
+    }
+
+    void registerSeats(const std::function<std::shared_ptr<PlayerStrategyV2>()>& factory) {
+        for (uint64_t seat = 0; seat < BENCH_PLAYERS; seat++) {
+            engine.registerStrategyV2(seat, factory());
+        }
+        engine.setSeed(seed);
+        engine.seedStrategies();
+    }
+
+    // Every card of the deck against every table of the corpus
+    void benchIsPlayable() {
+        std::vector<Card> deck;
+        bitboard::toCards(bitboard::FULL_DECK, deck);
+
+        Stopwatch watch;
+        uint64_t playable = 0;
+        watch.start();
+        for (const BenchPosition& position : corpus) {
+            engine.table_bits = position.view.table;
+            for (const Card& card : deck) {
+                playable += engine.isPlayable(card);
+            }
+        }
+        watch.stop();
+
+        report("MyGameMapper::isPlayable", corpus.size() * deck.size(), watch);
+        if (playable == 0) std::cout << "(no playable card found)\n";
+    }
+
+    void benchDealCards() {
+        registerSeats([] { return std::make_shared<RandomStrategy>(); });
+        const uint64_t rounds = 20000;
+
+        // The first deal builds the deck
+        engine.dealCards();
+
+        Stopwatch watch;
+        watch.start();
+        for (uint64_t round = 0; round < rounds; round++) {
+            engine.total_rounds = round;
+            engine.dealCards();
+        }
+        watch.stop();
+
+        report("MyGameMapper::dealCards", rounds, watch);
+    }
+
+    // Timed from the dealt position to the end of the round
+    void benchPlayRound() {
+        registerSeats([] { return std::make_shared<RandomStrategy>(); });
+        const uint64_t rounds = 20000;
+
+        Stopwatch watch;
+        for (uint64_t round = 0; round < rounds; round++) {
+            engine.total_rounds = round;
+            engine.resetTableLayout();
+            engine.dealCards();
+
+            watch.start();
+            engine.playRound(false);
+            watch.stop();
+        }
+
+        report("MyGameMapper::playRound 4x Random", rounds, watch);
+    }
+
+    void benchGames(const std::string& name, uint64_t games,
+                    const std::function<std::shared_ptr<PlayerStrategyV2>()>& factory)
+    {
+        registerSeats(factory);
+
+        Stopwatch watch;
+        watch.start();
+        for (uint64_t game = 0; game < games; game++) {
+            engine.setRandomStream(RngStream(seed).derive(game));
+            engine.runMultipleRounds(false);
+        }
+        watch.stop();
+
+        report(name, games, watch);
+        std::cout << "    " << std::setprecision(1) << games / watch.seconds << " games/sec\n";
+    }
+
+    // Both interfaces over the whole corpus. The strategy is initialized
+    // for each position's seat (inside the timed loop, it is cheap next to
+    // a decision) and sees no move history.
+    template <typename Strategy>
+    void benchStrategy(const std::shared_ptr<Strategy>& strategy) {
+        if (auto* seeded = dynamic_cast<SeededStrategy*>(strategy.get())) {
+            seeded->seedRandom(RngStream(seed));
+        }
+
+        int checksum = 0;
+        Stopwatch v1;
+        v1.start();
+        for (const BenchPosition& position : corpus) {
+            strategy->initialize(position.view.seat);
+            checksum += strategy->selectCardToPlay(position.hand, position.layout);
+        }
+        v1.stop();
+        report(strategy->getName() + "::selectCardToPlay", corpus.size(), v1);
+
+        Stopwatch v2;
+        v2.start();
+        for (const BenchPosition& position : corpus) {
+            strategy->initialize(position.view.seat);
+            checksum += strategy->selectCard(position.view);
+        }
+        v2.stop();
+        report(strategy->getName() + "::selectCard", corpus.size(), v2);
+
+        if (checksum == INT32_MIN) std::cout << "(checksum " << checksum << ")\n";
+    }
+};
+
+} // namespace sevens
+
+int main(int argc, char* argv[]) {
+    bool verify = argc > 1 && std::string(argv[1]) == "verify";
+    int arg = verify ? 2 : 1;
+    uint64_t numPositions = argc > arg ? std::stoull(argv[arg]) : 4096;
+    uint64_t seed = argc > arg + 1 ? std::stoull(argv[arg + 1]) : 1;
+
+    sevens::EngineBenchmark benchmark(numPositions, seed);
+    if (verify) {
+        return benchmark.verify() == 0 ? 0 : 1;
+    }
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Generic_card_parser.hpp"
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace sevens {
+
+/**
+ * Bitboard representation of a set of cards.
+ *
+ * The 64-bit word is split into four 16-bit lanes, one per suit
+ * (lane = suit * 16). Inside a lane, bit `rank` (1..13) is set when the
+ * card is in the set. Bits 0, 14 and 15 of every lane are always zero,
+ * so shifting a whole mask by one rank never leaks into the next suit.
+ */
+using CardMask = uint64_t;
+
+namespace bitboard {
+
+constexpr int SUIT_SHIFT = 16;
+
+// Ranks 1..13 of a single suit lane
+constexpr CardMask SUIT_RANKS = 0x3FFEULL;
+
+// Multiplier replicating a 16-bit lane pattern into all four suits
+constexpr CardMask LANES = 0x0001000100010001ULL;
+
+// Every card of the deck
+constexpr CardMask FULL_DECK = SUIT_RANKS * LANES;
+
+// The four sevens
+constexpr CardMask SEVENS = (CardMask(1) << 7) * LANES;
+
+// Bit position of a card inside a mask
+constexpr int cardBit(int suit, int rank) {
+    return suit * SUIT_SHIFT + rank;
+}
+
+constexpr CardMask cardMask(int suit, int rank) {
+    return CardMask(1) << cardBit(suit, rank);
+}
+
+inline CardMask cardMask(const Card& card) {
+    return cardMask(card.suit, card.rank);
+}
+
+// All cards of one suit present in the mask
+constexpr CardMask suitMask(int suit) {
+    return SUIT_RANKS << (suit * SUIT_SHIFT);
+}
+
+// The 13-bit rank pattern (rank r -> bit r-1) of a suit
+constexpr uint32_t suitRanks(CardMask mask, int suit) {
+    return static_cast<uint32_t>((mask >> (suit * SUIT_SHIFT + 1)) & 0x1FFF);
+}
+
+inline Card cardAt(int bit) {
+    return Card{bit / SUIT_SHIFT, bit % SUIT_SHIFT};
+}
+
+inline bool contains(CardMask mask, int suit, int rank) {
+    return (mask >> cardBit(suit, rank)) & 1;
+}
+
+inline int popcount(CardMask mask) {
+    return __builtin_popcountll(mask);
+}
+
+// Index of the lowest card in a non-empty mask
+inline int lowestBit(CardMask mask) {
+    return __builtin_ctzll(mask);
+}
+
+// Iterate the cards of a mask in suit/rank order: fn(bit)
+template <typename Fn>
+inline void forEachCard(CardMask mask, Fn&& fn) {
+    while (mask) {
+        fn(lowestBit(mask));
+        mask &= mask - 1;
+    }
+}
+
+// Build a bitboard from a list of cards
+inline CardMask fromCards(const std::vector<Card>& cards) {
+    CardMask mask = 0;
+    for (const Card& card : cards) {
+        mask |= cardMask(card);
+    }
+    return mask;
+}
+
+// Expand a bitboard into a list of cards in suit/rank order,
+// reusing the capacity of `out`
+inline void toCards(CardMask mask, std::vector<Card>& out) {
+    out.clear();
+    forEachCard(mask, [&](int bit) {
+        out.push_back(cardAt(bit));
+    });
+}
+
+// Build a bitboard from the legacy nested-map table layout
+inline CardMask fromTableLayout(
+    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& layout)
+{
+    CardMask mask = 0;
+    for (const auto& suitEntry : layout) {
+        if (suitEntry.first > 3) continue;
+        for (const auto& rankEntry : suitEntry.second) {
+            if (rankEntry.second && rankEntry.first >= 1 && rankEntry.first <= 13) {
+                mask |= cardMask(static_cast<int>(suitEntry.first),
+                                 static_cast<int>(rankEntry.first));
+            }
+        }
+    }
+    return mask;
+}
+
+/**
+ * Bring a legacy nested-map table layout in line with a bitboard.
+ * `mirrored` is the mask the map currently reflects; only the cards that
+ * differ are written, so keeping the map in step costs one hash write per
+ * card placed instead of a full rebuild.
+ */
+inline void syncTableLayout(
+    CardMask bits, CardMask& mirrored,
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& layout)
+{
+    if (layout.empty()) {
+        // First use: create every entry so plugins may call at() directly
+        for (int suit = 0; suit < 4; suit++) {
+            for (int rank = 1; rank <= 13; rank++) {
+                layout[suit][rank] = false;
+            }
+        }
+        mirrored = 0;
+    }
+
+    forEachCard(bits ^ mirrored, [&](int bit) {
+        Card card = cardAt(bit);
+        layout[card.suit][card.rank] = contains(bits, card.suit, card.rank);
+    });
+    mirrored = bits;
+}
+
+} // namespace bitboard
+
+} // namespace sevens
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "BeliefTracker.hpp"
+#include "Bitboard.hpp"
+#include "GameState.hpp"
+#include "PlayerStrategyV2.hpp"
+#include "RngStream.hpp"
+#include <cstdint>
+
+namespace sevens {
+
+// Deals drawn by DealSampler users
+struct DealStats {
+    uint64_t samples = 0;
+    uint64_t attempts = 0;    // includes the successful ones
+    uint64_t fallbacks = 0;   // deals that ignored the beliefs after MAX_ATTEMPTS failures
+
+    double rejectionRate() const {
+        return attempts ? 1.0 - double(samples - fallbacks) / attempts : 0.0;
+    }
+
+    void add(const DealStats& other) {
+        samples += other.samples;
+        attempts += other.attempts;
+        fallbacks += other.fallbacks;
+    }
+};
+
+/**
+ * Draws full deals consistent with a GameView and, optionally, with what
+ * a BeliefTracker rules out for each seat.
+ *
+ * The work that does not depend on the random draw is done once in the
+ * constructor. This covers the unseen cards, the number each other seat
+ * holds and, for each unseen card, the mask of seats allowed to hold it.
+ * Cards every seat may hold are "free". The others are placed first,
+ * fewest allowed seats first. Each one goes to an allowed seat that still
+ * has room, chosen with probability proportional to the room it has
+ * left. The free cards are then shuffled into the remaining slots, which
+ * always succeeds.
+ *
+ * Only the constrained cards can hit a dead end (every allowed seat is
+ * full). The attempt is then restarted, and after MAX_ATTEMPTS failures
+ * the deal ignores the beliefs. The beliefs are also ignored from the
+ * start when they leave a seat fewer possible cards than it holds, or a
+ * card with no possible seat. That only happens if a seat passed while
+ * holding a legal card. Without constraints a
+ * draw is a single shuffle.
+ *
+ * sample() is const, so one sampler can serve several threads, each with
+ * its own stream and DealStats.
+ */
+class DealSampler {
+public:
+    static constexpr int MAX_ATTEMPTS = 64;
+
+    explicit DealSampler(const GameView& view, const BeliefTracker* beliefs = nullptr) {
+        const int numPlayers = view.numPlayers < GameView::MAX_SEATS ? view.numPlayers : GameView::MAX_SEATS;
+        base.numPlayers = numPlayers;
+        base.toMove = view.seat;
+        base.table = view.table;
+        base.hands[view.seat] = view.hand;
+
+        const CardMask unseen = bitboard::FULL_DECK & ~view.table & ~view.hand;
+        for (int seat = 0; seat < numPlayers; seat++) {
+            need[seat] = seat == view.seat ? 0 : view.handCounts[seat];
+            if (need[seat] > 0) {
+                seatsWithCards |= 1u << seat;
+            }
+        }
+
+        // Cards each seat may hold; a seat left with too few, or a card
+        // left without a seat, means the beliefs are wrong
+        CardMask allowed[GameView::MAX_SEATS];
+        CardMask covered = 0;
+        bool feasible = true;
+        for (int seat = 0; seat < numPlayers; seat++) {
+            allowed[seat] = beliefs ? beliefs->possibleCards(seat, unseen) : unseen;
+            if (need[seat] > bitboard::popcount(allowed[seat])) {
+                feasible = false;
+            }
+            if (need[seat] > 0) {
+                covered |= allowed[seat];
+            }
+        }
+        if (!feasible || (seatsWithCards && covered != unseen)) {
+            for (int seat = 0; seat < numPlayers; seat++) {
+                allowed[seat] = unseen;
+            }
+        }
+
+        // Seats allowed to hold each unseen card, as a mask of seats
+        bitboard::forEachCard(unseen, [&](int bit) {
+            uint32_t seats = 0;
+            for (int seat = 0; seat < numPlayers; seat++) {
+                seats |= static_cast<uint32_t>((allowed[seat] >> bit) & 1) << seat;
+            }
+            seats &= seatsWithCards;
+            allCards[numCards++] = static_cast<uint8_t>(bit);
+            if (seats == seatsWithCards) {
+                freeCards[numFree++] = static_cast<uint8_t>(bit);
+            } else {
+                restricted[numRestricted] = static_cast<uint8_t>(bit);
+                restrictedSeats[numRestricted++] = seats;
+            }
+        });
+
+        // Most constrained cards first (insertion sort, at most 51 cards)
+        for (int i = 1; i < numRestricted; i++) {
+            uint8_t bit = restricted[i];
+            uint32_t seats = restrictedSeats[i];
+            int j = i;
+            for (; j > 0 && bitboard::popcount(restrictedSeats[j - 1]) > bitboard::popcount(seats); j--) {
+                restricted[j] = restricted[j - 1];
+                restrictedSeats[j] = restrictedSeats[j - 1];
+            }
+            restricted[j] = bit;
+            restrictedSeats[j] = seats;
+        }
+    }
+
+    // The beliefs rule out some card for some seat
+    bool constrained() const {
+        return numRestricted > 0;
+    }
+
+    GameState sample(RngStream& rng, DealStats* stats = nullptr) const {
+        GameState state = base;
+        if (!constrained()) {
+            dealFree(state, freeCards, numFree, need, rng);
+            if (stats) {
+                stats->samples++;
+                stats->attempts++;
+            }
+            return state;
+        }
+
+        int attempts = 0;
+        bool done = false;
+        while (!done && attempts < MAX_ATTEMPTS) {
+            attempts++;
+            state = base;
+            done = dealConstrained(state, rng);
+        }
+        if (!done) {
+            // Give up on the beliefs for this deal
+            state = base;
+            dealFree(state, allCards, numCards, need, rng);
+            if (stats) stats->fallbacks++;
+        }
+
+        if (stats) {
+            stats->samples++;
+            stats->attempts += attempts;
+        }
+        return state;
+    }
+
+private:
+    GameState base;                               // our hand and the table
+    int need[GameView::MAX_SEATS] = {};          // cards each seat holds (0 for us)
+    uint32_t seatsWithCards = 0;
+    uint8_t allCards[52];
+    uint8_t freeCards[52];
+    uint8_t restricted[52];
+    uint32_t restrictedSeats[52];
+    int numCards = 0;
+    int numFree = 0;
+    int numRestricted = 0;
+
+    // Place the restricted cards, then the free ones; false at a dead end
+    bool dealConstrained(GameState& state, RngStream& rng) const {
+        int room[GameView::MAX_SEATS];
+        for (int seat = 0; seat < state.numPlayers; seat++) {
+            room[seat] = need[seat];
+        }
+        uint32_t open = seatsWithCards;
+
+        for (int i = 0; i < numRestricted; i++) {
+            uint32_t seats = restrictedSeats[i] & open;
+            if (!seats) {
+                return false;
+            }
+
+            // Seat chosen in proportion to its room left
+            int total = 0;
+            for (uint32_t rest = seats; rest; rest &= rest - 1) {
+                total += room[bitboard::lowestBit(rest)];
+            }
+            int pick = static_cast<int>(rng.below(static_cast<uint32_t>(total)));
+            int seat = bitboard::lowestBit(seats);
+            for (uint32_t rest = seats; rest; rest &= rest - 1) {
+                seat = bitboard::lowestBit(rest);
+                pick -= room[seat];
+                if (pick < 0) break;
+            }
+
+            state.hands[seat] |= CardMask(1) << restricted[i];
+            if (--room[seat] == 0) {
+                open &= ~(1u << seat);
+            }
+        }
+
+        dealFree(state, freeCards, numFree, room, rng);
+        return true;
+    }
+
+    // Shuffle `cards` into the seats' remaining room, seat by seat
+    static void dealFree(GameState& state, const uint8_t* cards, int count, const int* room, RngStream& rng) {
+        uint8_t deck[52];
+        for (int i = 0; i < count; i++) {
+            deck[i] = cards[i];
+        }
+
+        // Partial Fisher-Yates: every card dealt is a uniform pick of the rest
+        int next = 0;
+        for (int seat = 0; seat < state.numPlayers; seat++) {
+            for (int n = 0; n < room[seat] && next < count; n++) {
+                int j = next + static_cast<int>(rng.below(static_cast<uint32_t>(count - next)));
+                uint8_t card = deck[j];
+                deck[j] = deck[next];
+                deck[next++] = card;
+                state.hands[seat] |= CardMask(1) << card;
+            }
+        }
+    }
+};
+
+} // namespace sevens
@@ -0,0 +1,330 @@
+// EndgameSolver.cpp
+#include "EndgameSolver.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace sevens {
+
+namespace {
+
+// Values are minus the cards we hold at the end of the round, so they
+// always lie inside (-VALUE_INF, VALUE_INF)
+const int VALUE_INF = 64;
+
+// Kinds of stored values
+const int BOUND_EXACT = 0;
+const int BOUND_LOWER = 1;   // true value >= stored value
+const int BOUND_UPPER = 2;   // true value <= stored value
+
+const int NO_MOVE = 0xFF;
+
+// Nodes a thread counts locally before adding them to the shared total
+const uint64_t NODE_BATCH = 1024;
+
+/**
+ * Zobrist keys: one per (seat, card) for the hands, one per seat for the
+ * seat to move and one per seat for the seat we search for. The table is
+ * implied by the hands (every card is either held or on the table).
+ */
+struct ZobristKeys {
+    uint64_t cards[GameState::MAX_SEATS][64];
+    uint64_t toMove[GameState::MAX_SEATS];
+    uint64_t perspective[GameState::MAX_SEATS];
+
+    ZobristKeys() {
+        RngStream rng(0x5EEDE11D);
+        for (auto& seat : cards) {
+            for (uint64_t& key : seat) {
+                key = rng();
+            }
+        }
+        for (uint64_t& key : toMove) {
+            key = rng();
+        }
+        for (uint64_t& key : perspective) {
+            key = rng();
+        }
+    }
+};
+
+const ZobristKeys& zobrist() {
+    static const ZobristKeys keys;
+    return keys;
+}
+
+uint64_t positionKey(const GameState& state, int seat) {
+    const ZobristKeys& keys = zobrist();
+    uint64_t key = keys.toMove[state.toMove] ^ keys.perspective[seat];
+    for (int player = 0; player < state.numPlayers; player++) {
+        bitboard::forEachCard(state.hands[player], [&](int bit) {
+            key ^= keys.cards[player][bit];
+        });
+    }
+    return key;
+}
+
+uint64_t readSetting(const char* name, uint64_t fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+} // namespace
+
+EndgameConfig EndgameConfig::fromEnvironment() {
+    EndgameConfig config;
+    config.maxCards = static_cast<int>(readSetting("FYM_ENDGAME_CARDS", config.maxCards));
+    config.nodeBudget = readSetting("FYM_ENDGAME_NODES", config.nodeBudget);
+    config.samples = static_cast<int>(readSetting("FYM_ENDGAME_SAMPLES", config.samples));
+    config.threads = static_cast<unsigned>(readSetting("FYM_ENDGAME_THREADS", config.threads));
+    config.tableEntries = readSetting("FYM_ENDGAME_TABLE", config.tableEntries);
+    return config;
+}
+
+// State of one search thread
+struct EndgameSolver::Search {
+    GameState state;
+    int seat;             // the seat we search for (maximizing)
+    uint64_t nodes = 0;   // not yet added to nodesUsed
+};
+
+EndgameSolver::EndgameSolver(const EndgameConfig& config) : settings(config) {
+    if (settings.samples < 1) settings.samples = 1;
+    if (settings.threads < 1) settings.threads = 1;
+
+    uint64_t size = 1;
+    while (size * 2 <= settings.tableEntries) {
+        size *= 2;
+    }
+    tableMask = size - 1;
+    table.reset(new Entry[size]);
+    for (uint64_t i = 0; i < size; i++) {
+        table[i].check.store(0, std::memory_order_relaxed);
+        table[i].data.store(0, std::memory_order_relaxed);
+    }
+    pool = std::make_unique<WorkerPool>(settings.threads);
+}
+
+EndgameSolver::~EndgameSolver() = default;
+
+bool EndgameSolver::applies(const GameView& view) const {
+    if (settings.maxCards <= 0 || view.numPlayers < 2 || view.numPlayers > GameState::MAX_SEATS) {
+        return false;
+    }
+
+    // The hand counts must account for every card off the table
+    int held = 0;
+    for (int seat = 0; seat < view.numPlayers; seat++) {
+        held += view.handCounts[seat];
+    }
+    int offTable = bitboard::popcount(bitboard::FULL_DECK & ~view.table);
+    return held == offTable && held <= settings.maxCards;
+}
+
+bool EndgameSolver::probe(uint64_t key, uint64_t& data) const {
+    const Entry& entry = table[key & tableMask];
+    uint64_t check = entry.check.load(std::memory_order_relaxed);
+    data = entry.data.load(std::memory_order_relaxed);
+    return (check ^ data) == key;
+}
+
+void EndgameSolver::store(uint64_t key, int value, int bound, int move) {
+    uint64_t data = static_cast<uint64_t>(value + VALUE_INF)
+                  | static_cast<uint64_t>(bound) << 8
+                  | static_cast<uint64_t>(move < 0 ? NO_MOVE : move) << 16;
+    Entry& entry = table[key & tableMask];
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+int EndgameSolver::search(Search& context, uint64_t key, int alpha, int beta) {
+    if (++context.nodes == NODE_BATCH) {
+        context.nodes = 0;
+        if (nodesUsed.fetch_add(NODE_BATCH, std::memory_order_relaxed) + NODE_BATCH > settings.nodeBudget) {
+            outOfNodes.store(true, std::memory_order_relaxed);
+        }
+    }
+    if (outOfNodes.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    const ZobristKeys& keys = zobrist();
+    GameState& state = context.state;
+    int seat = state.toMove;
+
+    CardMask legal = state.legalMoves();
+    if (!legal) {
+        if (state.blocked()) {
+            return -state.cardsLeft(context.seat);
+        }
+        state.pass();
+        int value = search(context, key ^ keys.toMove[seat] ^ keys.toMove[state.toMove], alpha, beta);
+        state.unpass(seat);
+        return value;
+    }
+
+    int tableMove = NO_MOVE;
+    uint64_t data;
+    if (probe(key, data)) {
+        int value = static_cast<int>(data & 0xFF) - VALUE_INF;
+        int bound = static_cast<int>(data >> 8) & 3;
+        if (bound == BOUND_EXACT
+            || (bound == BOUND_LOWER && value >= beta)
+            || (bound == BOUND_UPPER && value <= alpha)) {
+            return value;
+        }
+        tableMove = static_cast<int>(data >> 16) & 0xFF;
+    }
+
+    const bool maximizing = seat == context.seat;
+    const int alphaIn = alpha;
+    const int betaIn = beta;
+    int best = maximizing ? -VALUE_INF : VALUE_INF;
+    int bestMove = -1;
+
+    // Returns true on a cutoff
+    auto tryMove = [&](int bit) {
+        state.makeMove(bit);
+        int value;
+        if (state.hands[seat] == 0) {
+            // The round ends with this card
+            value = -state.cardsLeft(context.seat);
+        } else {
+            uint64_t child = key ^ keys.cards[seat][bit] ^ keys.toMove[seat] ^ keys.toMove[state.toMove];
+            value = search(context, child, alpha, beta);
+        }
+        state.unmakeMove(bit, seat);
+
+        if (maximizing) {
+            if (value > best) {
+                best = value;
+                bestMove = bit;
+            }
+            if (value > alpha) alpha = value;
+        } else {
+            if (value < best) {
+                best = value;
+                bestMove = bit;
+            }
+            if (value < beta) beta = value;
+        }
+        return alpha >= beta;
+    };
+
+    // The stored best move first, then the others in card order
+    bool cutoff = false;
+    if (tableMove != NO_MOVE && (legal >> tableMove & 1)) {
+        cutoff = tryMove(tableMove);
+        legal &= ~(CardMask(1) << tableMove);
+    }
+    while (legal && !cutoff) {
+        int bit = bitboard::lowestBit(legal);
+        legal &= legal - 1;
+        cutoff = tryMove(bit);
+    }
+
+    // A search cut short by the budget leaves nothing worth keeping
+    if (outOfNodes.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    int bound = best <= alphaIn ? BOUND_UPPER : best >= betaIn ? BOUND_LOWER : BOUND_EXACT;
+    store(key, best, bound, bestMove);
+    return best;
+}
+
+void EndgameSolver::searchRoots(const GameState* deals, int seat, const int* rootMoves, int numMoves,
+                                int numItems, std::atomic<int>& nextItem, int* values)
+{
+    const ZobristKeys& keys = zobrist();
+    Search context;
+    context.seat = seat;
+
+    for (;;) {
+        int item = nextItem.fetch_add(1, std::memory_order_relaxed);
+        if (item >= numItems || outOfNodes.load(std::memory_order_relaxed)) break;
+
+        int bit = rootMoves[item % numMoves];
+        context.state = deals[item / numMoves];
+        uint64_t key = positionKey(context.state, seat);
+
+        context.state.makeMove(bit);
+        if (context.state.hands[seat] == 0) {
+            values[item] = 0; // we go out
+        } else {
+            uint64_t child = key ^ keys.cards[seat][bit] ^ keys.toMove[seat] ^ keys.toMove[context.state.toMove];
+            values[item] = search(context, child, -VALUE_INF, VALUE_INF);
+        }
+    }
+
+    nodesUsed.fetch_add(context.nodes, std::memory_order_relaxed);
+}
+
+int EndgameSolver::solve(const GameView& view, RngStream& rng, const BeliefTracker* beliefs) {
+    auto start = std::chrono::steady_clock::now();
+    nodesUsed.store(0, std::memory_order_relaxed);
+    outOfNodes.store(false, std::memory_order_relaxed);
+
+    int rootMoves[moves::MAX_PLAYABLE];
+    int numMoves = 0;
+    bitboard::forEachCard(view.legalMoves(), [&](int bit) {
+        if (numMoves < moves::MAX_PLAYABLE) rootMoves[numMoves++] = bit;
+    });
+    if (numMoves == 0) {
+        return -1;
+    }
+
+    // Every (deal, root move) pair is one work item; the scratch vectors
+    // keep their capacity between decisions
+    DealSampler sampler(view, beliefs);
+    deals.resize(settings.samples);
+    for (GameState& deal : deals) {
+        deal = sampler.sample(rng);
+    }
+    int numItems = settings.samples * numMoves;
+    values.assign(numItems, 0);
+    std::atomic<int> nextItem{0};
+
+    auto job = [&](unsigned) {
+        searchRoots(deals.data(), view.seat, rootMoves, numMoves, numItems, nextItem, values.data());
+    };
+    pool->run(job);
+
+    totals.nodes += nodesUsed.load(std::memory_order_relaxed);
+    totals.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (outOfNodes.load(std::memory_order_relaxed)) {
+        totals.aborted++;
+        return -1;
+    }
+    totals.solves++;
+
+    // Best total over the deals, lowest card on ties
+    int best = 0;
+    int bestTotal = 0;
+    for (int move = 0; move < numMoves; move++) {
+        int total = 0;
+        for (int sample = 0; sample < settings.samples; sample++) {
+            total += values[sample * numMoves + move];
+        }
+        if (move == 0 || total > bestTotal) {
+            best = move;
+            bestTotal = total;
+        }
+    }
+    return rootMoves[best];
+}
+
+int EndgameSolver::evaluate(const GameState& state, int seat) {
+    nodesUsed.store(0, std::memory_order_relaxed);
+    outOfNodes.store(false, std::memory_order_relaxed);
+
+    Search context;
+    context.state = state;
+    context.seat = seat;
+    int value = search(context, positionKey(state, seat), -VALUE_INF, VALUE_INF);
+    nodesUsed.fetch_add(context.nodes, std::memory_order_relaxed);
+    return outOfNodes.load(std::memory_order_relaxed) ? INT32_MIN : value;
+}
+
+} // namespace sevens
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "DealSampler.hpp"
+#include "GameState.hpp"
+#include "PlayerStrategyV2.hpp"
+#include "RngStream.hpp"
+#include "WorkerPool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sevens {
+
+// Settings of the endgame solver; maxCards == 0 turns it off
+struct EndgameConfig {
+    int maxCards = 0;                  // solve when at most this many cards are left in all hands
+    uint64_t nodeBudget = 200000;      // nodes per decision before giving up
+    int samples = 8;                   // deals of the unseen cards searched per decision
+    unsigned threads = 1;              // search threads sharing the table
+    uint64_t tableEntries = 1 << 18;   // transposition table size (rounded down to a power of two)
+
+    // Read from FYM_ENDGAME_CARDS, FYM_ENDGAME_NODES, FYM_ENDGAME_SAMPLES,
+    // FYM_ENDGAME_THREADS and FYM_ENDGAME_TABLE (unset ones keep the defaults)
+    static EndgameConfig fromEnvironment();
+};
+
+// Work done by a solver since it was created
+struct EndgameStats {
+    uint64_t solves = 0;     // decisions searched to the end
+    uint64_t aborted = 0;    // decisions that ran out of nodes
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * Exact endgame search for one seat.
+ *
+ * The other hands are unknown, so each decision searches several deals
+ * of the unseen cards consistent with the view (DealSampler) to the
+ * end of the round, and plays the move with the best total over the deals.
+ * A position is worth minus the cards we still hold when the round ends,
+ * and the search is "paranoid": every other seat is assumed to play
+ * against us, which turns the game into a two-sided alpha-beta search.
+ *
+ * Positions are stored in a lockless transposition table keyed by a
+ * Zobrist hash; with several threads (a WorkerPool started with the
+ * solver), the root moves of a deal are split between them and they
+ * share the table.
+ */
+class EndgameSolver {
+public:
+    explicit EndgameSolver(const EndgameConfig& config);
+    ~EndgameSolver();
+
+    // True if view's position is small enough to be solved
+    bool applies(const GameView& view) const;
+
+    // Best card (bit) for view.seat, or -1 if the node budget ran out.
+    // Deals are drawn to agree with `beliefs` when given.
+    int solve(const GameView& view, RngStream& rng, const BeliefTracker* beliefs = nullptr);
+
+    // Value for `seat` of a round in progress with every hand known (minus
+    // the cards it holds at the end), searched on the calling thread with
+    // the shared table; INT32_MIN if the node budget ran out
+    int evaluate(const GameState& state, int seat);
+
+    const EndgameConfig& config() const { return settings; }
+    const EndgameStats& stats() const { return totals; }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;   // key ^ data
+        std::atomic<uint64_t> data;    // value, bound and best move
+    };
+
+    struct Search;
+
+    int search(Search& context, uint64_t key, int alpha, int beta);
+
+    // Worker loop: search (deal, root move) pairs until none is left
+    void searchRoots(const GameState* deals, int seat, const int* rootMoves, int numMoves,
+                     int numItems, std::atomic<int>& nextItem, int* values);
+
+    bool probe(uint64_t key, uint64_t& data) const;
+    void store(uint64_t key, int value, int bound, int move);
+
+    EndgameConfig settings;
+    EndgameStats totals;
+    std::unique_ptr<Entry[]> table;
+    uint64_t tableMask;
+    std::unique_ptr<WorkerPool> pool;
+    std::vector<GameState> deals;
+    std::vector<int> values;
+    std::atomic<uint64_t> nodesUsed{0};
+    std::atomic<bool> outOfNodes{false};
+};
+
+} // namespace sevens
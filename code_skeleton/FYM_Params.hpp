@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace sevens {
+
+namespace fym {
+
+/**
+ * The tunable weights of FYM_Quest's move score, as a parameter vector.
+ *
+ * The defaults are the hand-tuned values the strategy always used. A
+ * parameter file has one "name value" pair per line ('#' starts a
+ * comment) and only needs the values that differ from the defaults; it
+ * is what `sevens_game tune` writes and what FYM_PARAMS points to.
+ */
+struct Params {
+    static const int COUNT = 11;
+
+    double sequence = 2.5;       // primary focus on sequences
+    double seven = 1.5;          // moderate weight for 7s
+    double balance = 1.2;        // some consideration for suit balance
+    double blocking = 0.8;       // minor consideration for blocking
+    double extremes = 1.7;       // extreme cards, scaled up as the round goes on
+    double extremesPhase = 0.3;  // ... by this much per game phase
+    double futureEarly = 0.3;    // future plays, early and mid game
+    double futureLate = 0.5;     // future plays, late game and end game
+    double futureEndgame = 2.0;  // extra factor on future plays in the end game
+    double stuckPenalty = -4.0;  // late-game move that leaves no future play
+    double lateBonus = 0.3;      // late-game bonus, times (4 - game phase)
+
+    static const char* name(int index) {
+        static const char* const NAMES[COUNT] = {
+            "sequence", "seven", "balance", "blocking", "extremes", "extremes_phase",
+            "future_early", "future_late", "future_endgame", "stuck_penalty", "late_bonus"
+        };
+        return NAMES[index];
+    }
+
+    double& operator[](int index) { return this->*member(index); }
+    double operator[](int index) const { return this->*member(index); }
+
+    // Index of the parameter called `paramName`, or -1
+    static int find(const std::string& paramName) {
+        for (int i = 0; i < COUNT; i++) {
+            if (paramName == name(i)) return i;
+        }
+        return -1;
+    }
+
+    // 0 for the defaults, otherwise a hash of the values; mixed into the
+    // transposition cache keys so instances with other weights do not
+    // share scores
+    uint64_t key() const {
+        const Params defaults;
+        uint64_t hash = 0;
+        bool changed = false;
+        for (int i = 0; i < COUNT; i++) {
+            double value = (*this)[i];
+            changed |= value != defaults[i];
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof bits);
+            hash = (hash ^ bits) * 0x100000001B3ULL;
+            hash ^= hash >> 29;
+        }
+        return changed ? hash | 1 : 0;
+    }
+
+    // Read the values in `path` over the current ones; false (with
+    // `error` set) if the file cannot be read or names an unknown value
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "cannot open " + path;
+            return false;
+        }
+        Params loaded = *this;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            line = line.substr(0, line.find('#'));
+            std::istringstream fields(line);
+            std::string paramName;
+            double value;
+            if (!(fields >> paramName)) continue;
+            int index = find(paramName);
+            if (index < 0 || !(fields >> value)) {
+                error = path + ":" + std::to_string(lineNumber) + ": expected <name> <value>";
+                return false;
+            }
+            loaded[index] = value;
+        }
+        *this = loaded;
+        return true;
+    }
+
+    // The defaults, overridden by the file named in FYM_PARAMS if set (a
+    // file that cannot be read is reported on stderr and ignored)
+    static Params fromEnvironment() {
+        Params params;
+        const char* path = std::getenv("FYM_PARAMS");
+        std::string error;
+        if (path && *path && !params.load(path, error)) {
+            std::cerr << "FYM_PARAMS: " << error << "\n";
+        }
+        return params;
+    }
+
+private:
+    static double Params::* member(int index) {
+        static double Params::* const MEMBERS[COUNT] = {
+            &Params::sequence, &Params::seven, &Params::balance, &Params::blocking,
+            &Params::extremes, &Params::extremesPhase, &Params::futureEarly, &Params::futureLate,
+            &Params::futureEndgame, &Params::stuckPenalty, &Params::lateBonus
+        };
+        return MEMBERS[index];
+    }
+};
+
+} // namespace fym
+
+} // namespace sevens
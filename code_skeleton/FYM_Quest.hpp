@@ -0,0 +1,132 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include "PlayerStrategyV2.hpp"
+#include "LegalMoves.hpp"
+#include "FYM_TranspositionCache.hpp"
+#include "FYM_Params.hpp"
+#include "EndgameSolver.hpp"
+#include "BeliefTracker.hpp"
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+namespace sevens {
+
+/**
+ * FYM_Quest: A refined strategy that builds on SequenceStrategy's strengths
+ * while incorporating adaptivity elements from BalanceStrategy and defensive aspects
+ * from BlockingStrategy. This strategy performs enhanced sequence analysis and adapts
+ * its approach based on player count, game phase, and board state.
+ */
+class FYM_Quest : public PlayerStrategy, public PlayerStrategyV2, public SeededStrategy,
+                  public TunableStrategy {
+public:
+    FYM_Quest();
+    virtual ~FYM_Quest();
+
+    // PlayerStrategy interface
+    void initialize(uint64_t playerID) override;
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override;
+    void observeMove(uint64_t playerID, const Card& playedCard) override;
+    void observePass(uint64_t playerID) override;
+    std::string getName() const override;
+
+    // PlayerStrategyV2 interface
+    int selectCard(GameView view) override;
+
+    // SeededStrategy interface
+    void seedRandom(const RngStream& stream) override;
+
+    // TunableStrategy interface (the values of fym::Params)
+    int parameterCount() const override;
+    std::string parameterName(int index) const override;
+    double getParameter(int index) const override;
+    void setParameter(int index, double value) override;
+
+    // Score weights, from FYM_PARAMS by default
+    void setParams(const fym::Params& newParams);
+    const fym::Params& getParams() const { return params; }
+
+    // Cache used to skip re-scoring known positions (null = none). By
+    // default the process-wide one from FYM_CACHE_ENTRIES. Hit and miss
+    // counts are added to the cache when it is replaced or on destruction.
+    void setTranspositionCache(fym::TranspositionCache* newCache);
+
+    // Exact search of small endgames (GameView path only). Configured from
+    // the FYM_ENDGAME_* environment variables by default; off when
+    // config.maxCards is 0. endgameStats() is null while it is off.
+    void setEndgameConfig(const EndgameConfig& config);
+    const EndgameStats* endgameStats() const;
+
+private:
+    // Game state tracking
+    uint64_t myID;
+    RngStream rng;
+    int roundTurn = 0;
+    uint64_t playerCount = 0;
+    int consecutivePasses = 0;
+
+    // Strategy weights (see FYM_Params.hpp for the defaults) and their
+    // cache key salt, 0 for the defaults
+    fym::Params params;
+    uint64_t paramsKey = 0;
+
+    // Tracking for each suit
+    std::array<int, 4> sevenStatus = {0, 0, 0, 0};  // 0=unknown, 1=in hand, -1=played
+    std::array<int, 4> suitCounts = {0, 0, 0, 0};   // Cards per suit in hand
+    std::array<double, 4> suitImbalance = {0.0, 0.0, 0.0, 0.0};  // Imbalance measure
+
+    // Decision cache and this instance's pending lookup counts
+    fym::TranspositionCache* cache = nullptr;
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+    void flushCacheCounts();
+
+    // Endgame solver, null when off
+    std::unique_ptr<EndgameSolver> endgame;
+
+    // Cards ruled out for the other seats by their passes
+    BeliefTracker beliefs;
+
+    // Current hand as a bitboard, refreshed at the start of every decision
+    CardMask handMask = 0;
+    int handSize = 0;
+
+    // Position after one of our cards is played. make() applies the move
+    // to copies of the hand and table, so undoing it is free.
+    struct SimulatedMove {
+        CardMask hand;   // our remaining cards
+        CardMask table;
+
+        static SimulatedMove make(CardMask hand, CardMask table, int bit) {
+            CardMask card = CardMask(1) << bit;
+            return SimulatedMove{hand & ~card, table | card};
+        }
+    };
+
+    // Pick the position in `candidates` (card bits) of the card to play,
+    // or -1 to pass. Candidates are scored in the order given. `view` is
+    // null for the version 1 interface, which cannot run the endgame solver.
+    int chooseCard(CardMask hand, CardMask table, const moves::PlayableList& candidates,
+                   const GameView* view = nullptr);
+
+    // Game state analysis
+    void updateGameState(CardMask table);
+    void calculateSuitImbalance();
+    int estimatePlayerCount(int handSize) const;
+    int getGamePhase(int handSize) const;
+
+    // Move evaluation
+    int analyzeSequence(const SimulatedMove& move) const;
+    bool isExtremeCard(const Card& card) const;
+    int countFuturePlays(const SimulatedMove& move) const;
+    bool hasBlockingPotential(const Card& card, CardMask table) const;
+    double scoreMoveEnhanced(int bit, CardMask table, int gamePhase) const;
+};
+
+} // namespace sevens
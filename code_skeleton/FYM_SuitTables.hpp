@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include <cstdint>
+
+namespace sevens {
+
+/**
+ * Lookup tables for FYM_Quest's move simulations.
+ *
+ * A card only ever extends its own suit, and the cards of a suit on the
+ * table always form one interval [lo, hi] around the 7 (or nothing). So
+ * how far we can chain plays in a suit is the run of our cards just below
+ * lo plus the run just above hi, and each run only depends on the bound
+ * and the six ranks on that side of the 7. Both are read from 7x64-entry
+ * tables built at compile time; a whole position is four suits of two
+ * reads each.
+ *
+ * `sevens_bench verify` checks them against the original map-based
+ * simulations they replace.
+ */
+namespace fym {
+
+struct SuitTables {
+    // low[lo][h]: our cards at lo-1, lo-2, ... in a row; h = ranks 1..6 (bit r-1)
+    uint8_t low[8][64];
+    // high[hi][h]: our cards at hi+1, hi+2, ... in a row; h = ranks 8..13 (bit r-8)
+    uint8_t high[14][64];
+};
+
+constexpr SuitTables makeSuitTables() {
+    SuitTables tables{};
+    for (int bound = 1; bound <= 7; bound++) {
+        for (int h = 0; h < 64; h++) {
+            int run = 0;
+            for (int rank = bound - 1; rank >= 1 && ((h >> (rank - 1)) & 1); rank--) {
+                run++;
+            }
+            tables.low[bound][h] = static_cast<uint8_t>(run);
+        }
+    }
+    for (int bound = 7; bound <= 13; bound++) {
+        for (int h = 0; h < 64; h++) {
+            int run = 0;
+            for (int rank = bound + 1; rank <= 13 && ((h >> (rank - 8)) & 1); rank++) {
+                run++;
+            }
+            tables.high[bound][h] = static_cast<uint8_t>(run);
+        }
+    }
+    return tables;
+}
+
+constexpr SuitTables SUIT_TABLES = makeSuitTables();
+
+// Runs below and above the table interval of one suit. `hand` and `table`
+// are rank patterns from bitboard::suitRanks. With no card of the suit on
+// the table, a 7 in hand opens the interval [7, 7].
+struct SuitRuns {
+    int low;
+    int high;
+    int seven;  // 1 when the 7 itself is still ours to play
+};
+
+inline SuitRuns suitRuns(uint32_t hand, uint32_t table) {
+    const uint32_t SEVEN = 1u << 6;
+    int seven = 0;
+    if (!table) {
+        if (!(hand & SEVEN)) {
+            return SuitRuns{0, 0, 0};
+        }
+        table = SEVEN;
+        seven = 1;
+    }
+
+    int lo = __builtin_ctz(table) + 1;
+    int hi = 32 - __builtin_clz(table);
+    return SuitRuns{SUIT_TABLES.low[lo][hand & 63],
+                    SUIT_TABLES.high[hi][(hand >> 7) & 63],
+                    seven};
+}
+
+// Cards of `hand` we could play in a row from this table if nobody else
+// played: every card that becomes playable is played in turn
+inline int sequenceLength(CardMask hand, CardMask table) {
+    int length = 0;
+    for (int suit = 0; suit < 4; suit++) {
+        SuitRuns runs = suitRuns(bitboard::suitRanks(hand, suit), bitboard::suitRanks(table, suit));
+        length += runs.seven + runs.low + runs.high;
+    }
+    return length;
+}
+
+// Cards of `hand` playable on this table
+inline int playableCount(CardMask hand, CardMask table) {
+    int count = 0;
+    for (int suit = 0; suit < 4; suit++) {
+        SuitRuns runs = suitRuns(bitboard::suitRanks(hand, suit), bitboard::suitRanks(table, suit));
+        count += runs.seven ? 1 : (runs.low > 0) + (runs.high > 0);
+    }
+    return count;
+}
+
+} // namespace fym
+
+} // namespace sevens
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include "LegalMoves.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace sevens {
+
+namespace fym {
+
+/**
+ * Fixed-size transposition cache for FYM_Quest decisions.
+ *
+ * Maps a position (hand, table, player count) to the scores of its legal
+ * moves without the random tie-break, one slot per legal move in card
+ * order. The tie-break is drawn after the lookup, so a hit gives exactly
+ * the decision a fresh computation would have given.
+ *
+ * The cache is shared by every thread without locks: each word is a
+ * relaxed atomic and an entry stores key ^ (all score words) as its
+ * check, so an entry torn by two concurrent writers, or one belonging to
+ * another position, fails the check and reads as a miss. Entries are
+ * simply overwritten (always-replace).
+ */
+class TranspositionCache {
+public:
+    static const int MAX_CANDIDATES = moves::MAX_PLAYABLE;
+
+    // `entries` is rounded down to a power of two (at least 1)
+    explicit TranspositionCache(uint64_t entries) {
+        uint64_t size = 1;
+        while (size * 2 <= entries) {
+            size *= 2;
+        }
+        mask = size - 1;
+        table.reset(new Entry[size]);
+        for (uint64_t i = 0; i < size; i++) {
+            table[i].check.store(0, std::memory_order_relaxed);
+            for (int s = 0; s < MAX_CANDIDATES; s++) {
+                table[i].scores[s].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static uint64_t positionKey(CardMask hand, CardMask table, uint64_t players) {
+        uint64_t key = mix(hand + 0x9E3779B97F4A7C15ULL);
+        key = mix(key ^ table);
+        return mix(key ^ players);
+    }
+
+    // Copy the scores of `key` into `scores` (MAX_CANDIDATES slots)
+    bool probe(uint64_t key, double* scores) const {
+        const Entry& entry = table[key & mask];
+        uint64_t words[MAX_CANDIDATES];
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        for (int s = 0; s < MAX_CANDIDATES; s++) {
+            words[s] = entry.scores[s].load(std::memory_order_relaxed);
+            check ^= words[s];
+        }
+        if (check != key) {
+            return false;
+        }
+        std::memcpy(scores, words, sizeof(words));
+        return true;
+    }
+
+    void store(uint64_t key, const double* scores) {
+        Entry& entry = table[key & mask];
+        uint64_t words[MAX_CANDIDATES];
+        std::memcpy(words, scores, sizeof(words));
+        uint64_t check = key;
+        for (int s = 0; s < MAX_CANDIDATES; s++) {
+            entry.scores[s].store(words[s], std::memory_order_relaxed);
+            check ^= words[s];
+        }
+        entry.check.store(check, std::memory_order_relaxed);
+    }
+
+    uint64_t size() const { return mask + 1; }
+
+    // Lookups are counted by each user and added here in batches, so the
+    // counters do not bounce between threads
+    void addCounts(uint64_t newHits, uint64_t newMisses) {
+        hitCount.fetch_add(newHits, std::memory_order_relaxed);
+        missCount.fetch_add(newMisses, std::memory_order_relaxed);
+    }
+
+    uint64_t hits() const { return hitCount.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return missCount.load(std::memory_order_relaxed); }
+
+    // Process-wide cache sized by the FYM_CACHE_ENTRIES environment
+    // variable, or null (no caching) when it is unset or 0
+    static TranspositionCache* shared() {
+        static std::unique_ptr<TranspositionCache> cache = [] {
+            const char* value = std::getenv("FYM_CACHE_ENTRIES");
+            uint64_t entries = value ? std::strtoull(value, nullptr, 10) : 0;
+            return entries ? std::make_unique<TranspositionCache>(entries) : nullptr;
+        }();
+        return cache.get();
+    }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> scores[MAX_CANDIDATES];
+    };
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    std::unique_ptr<Entry[]> table;
+    uint64_t mask;
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+};
+
+} // namespace fym
+
+} // namespace sevens
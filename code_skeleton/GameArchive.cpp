@@ -0,0 +1,627 @@
+// GameArchive.cpp
+#include "GameArchive.hpp"
+#include "GameRecord.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace sevens {
+
+namespace {
+
+const char MAGIC[4] = {'S', 'V', 'G', 'A'};
+const uint32_t VERSION = 1;
+
+// On-disk sizes of the header (before the description), a run table
+// entry, a block table entry and the footer
+const size_t HEADER_SIZE = 12;
+const size_t RUN_ENTRY_SIZE = 20;
+const size_t BLOCK_ENTRY_SIZE = 16;
+const size_t FOOTER_SIZE = 48;
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint32_t getU32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= uint32_t(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t getU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= uint64_t(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Read a varint at `pos`, advancing it; false if it runs past `size`
+bool getVarint(const uint8_t* in, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < size; shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+/**
+ * Huffman block coder.
+ *
+ * A coded block is the code length of every byte value (4 bits each, 0
+ * for values absent from the block, 128 bytes in all) followed by the
+ * canonical Huffman codes of its bytes, packed LSB first. Records are
+ * mostly small move indices and passes, with a few bytes per round of
+ * packed deals, so their bytes have under 4 bits of entropy and a code
+ * per byte value takes about half the raw size. Codes are limited to
+ * MAX_BITS, so that decoding is one table lookup per byte.
+ */
+namespace huffman {
+
+const int MAX_BITS = 12;
+const size_t LENGTHS_SIZE = 128;
+
+// Code lengths of the byte values from their counts; lengths over
+// MAX_BITS are avoided by flattening the counts and trying again
+void codeLengths(const uint64_t* counts, uint8_t* lengths) {
+    std::vector<uint64_t> weights(counts, counts + 256);
+    for (;;) {
+        // Nodes 0..255 are the byte values, the rest are merged pairs
+        std::vector<std::pair<uint64_t, int>> heap;
+        std::vector<int> parent(512, -1);
+        for (int value = 0; value < 256; value++) {
+            if (weights[value]) heap.push_back({weights[value], value});
+        }
+        std::fill(lengths, lengths + 256, 0);
+        if (heap.size() == 1) {
+            lengths[heap[0].second] = 1;
+            return;
+        }
+
+        auto heavier = [](const std::pair<uint64_t, int>& a, const std::pair<uint64_t, int>& b) { return a > b; };
+        std::make_heap(heap.begin(), heap.end(), heavier);
+        int next = 256;
+        while (heap.size() > 1) {
+            std::pop_heap(heap.begin(), heap.end(), heavier);
+            auto a = heap.back();
+            heap.pop_back();
+            std::pop_heap(heap.begin(), heap.end(), heavier);
+            auto b = heap.back();
+            heap.pop_back();
+            parent[a.second] = parent[b.second] = next;
+            heap.push_back({a.first + b.first, next++});
+            std::push_heap(heap.begin(), heap.end(), heavier);
+        }
+
+        int longest = 0;
+        for (int value = 0; value < 256; value++) {
+            if (!weights[value]) continue;
+            int length = 0;
+            for (int node = value; parent[node] >= 0; node = parent[node]) {
+                length++;
+            }
+            lengths[value] = static_cast<uint8_t>(length);
+            longest = std::max(longest, length);
+        }
+        if (longest <= MAX_BITS) return;
+
+        for (uint64_t& weight : weights) {
+            if (weight) weight = (weight >> 1) | 1;
+        }
+    }
+}
+
+// Canonical codes, bit-reversed for LSB-first packing; false if the
+// lengths do not form a prefix code
+bool canonicalCodes(const uint8_t* lengths, uint32_t* codes) {
+    uint32_t code = 0;
+    uint64_t kraft = 0;
+    for (int length = 1; length <= MAX_BITS; length++) {
+        for (int value = 0; value < 256; value++) {
+            if (lengths[value] != length) continue;
+            uint32_t reversed = 0;
+            for (int bit = 0; bit < length; bit++) {
+                reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+            }
+            codes[value] = reversed;
+            code++;
+            kraft += uint64_t(1) << (MAX_BITS - length);
+        }
+        code <<= 1;
+    }
+    return kraft <= (uint64_t(1) << MAX_BITS);
+}
+
+void compress(const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+    // Four tables, so that runs of one byte value do not wait on a
+    // single counter
+    uint32_t partial[4][256] = {};
+    const uint8_t* data = in.data();
+    const size_t size = in.size();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        partial[0][data[i]]++;
+        partial[1][data[i + 1]]++;
+        partial[2][data[i + 2]]++;
+        partial[3][data[i + 3]]++;
+    }
+    for (; i < size; i++) {
+        partial[0][data[i]]++;
+    }
+    uint64_t counts[256];
+    for (int value = 0; value < 256; value++) {
+        counts[value] = uint64_t(partial[0][value]) + partial[1][value] + partial[2][value] + partial[3][value];
+    }
+
+    uint8_t lengths[256];
+    uint32_t codes[256] = {};
+    codeLengths(counts, lengths);
+    canonicalCodes(lengths, codes);
+
+    // MAX_BITS per byte at most, and room for the 8-byte stores
+    out.resize(LENGTHS_SIZE + size * MAX_BITS / 8 + 16);
+    for (size_t k = 0; k < LENGTHS_SIZE; k++) {
+        out[k] = static_cast<uint8_t>(lengths[2 * k] | lengths[2 * k + 1] << 4);
+    }
+
+    // Up to four codes (48 bits) join the fewer than 8 bits pending, then
+    // the whole bytes are stored
+    // Code and length of each byte value in one word: code << 4 | length
+    uint32_t entries[256];
+    for (int value = 0; value < 256; value++) {
+        entries[value] = codes[value] << 4 | lengths[value];
+    }
+
+    uint8_t* op = out.data() + LENGTHS_SIZE;
+    uint64_t pending = 0;
+    int used = 0;
+    auto put = [&](uint8_t byte) {
+        uint32_t entry = entries[byte];
+        pending |= uint64_t(entry >> 4) << used;
+        used += entry & 15;
+    };
+    auto flush = [&]() {
+        for (int k = 0; k < 8; k++) {
+            op[k] = static_cast<uint8_t>(pending >> (8 * k));
+        }
+        op += used >> 3;
+        pending >>= used & ~7;
+        used &= 7;
+    };
+    for (i = 0; i + 4 <= size; i += 4) {
+        put(data[i]);
+        put(data[i + 1]);
+        put(data[i + 2]);
+        put(data[i + 3]);
+        flush();
+    }
+    for (; i < size; i++) {
+        put(data[i]);
+        flush();
+    }
+    if (used > 0) {
+        *op++ = static_cast<uint8_t>(pending);
+    }
+    out.resize(op - out.data());
+}
+
+// Decode exactly out.size() bytes; false if the input is damaged
+bool decompress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) {
+    if (size < LENGTHS_SIZE) return false;
+    uint8_t lengths[256];
+    for (size_t i = 0; i < LENGTHS_SIZE; i++) {
+        lengths[2 * i] = in[i] & 15;
+        lengths[2 * i + 1] = in[i] >> 4;
+    }
+    uint32_t codes[256] = {};
+    for (uint8_t length : lengths) {
+        if (length > MAX_BITS) return false;
+    }
+    if (!canonicalCodes(lengths, codes)) return false;
+
+    // Every MAX_BITS-bit window starting with a code: value << 4 | length
+    std::vector<uint16_t> table(size_t(1) << MAX_BITS, 0);
+    for (int value = 0; value < 256; value++) {
+        if (!lengths[value]) continue;
+        for (uint32_t rest = 0; rest < (1u << (MAX_BITS - lengths[value])); rest++) {
+            table[codes[value] | rest << lengths[value]] = static_cast<uint16_t>(value << 4 | lengths[value]);
+        }
+    }
+
+    size_t pos = LENGTHS_SIZE;
+    uint64_t pending = 0;
+    int available = 0;
+    for (uint8_t& byte : out) {
+        while (available <= 56 && pos < size) {
+            pending |= uint64_t(in[pos++]) << available;
+            available += 8;
+        }
+        uint16_t entry = table[pending & ((1u << MAX_BITS) - 1)];
+        int length = entry & 15;
+        if (length == 0 || length > available) return false;
+        byte = static_cast<uint8_t>(entry >> 4);
+        pending >>= length;
+        available -= length;
+    }
+    return true;
+}
+
+} // namespace huffman
+
+} // namespace
+
+void ArchiveBlock::add(uint64_t game, const uint8_t* log, size_t size) {
+    if (raw.empty()) {
+        raw.reserve(BLOCK_SIZE + BLOCK_SIZE / 8);
+    }
+    if (runs.empty() || runs.back().firstGame + runs.back().games != game) {
+        runs.push_back({game, 0, static_cast<uint32_t>(raw.size())});
+    }
+    runs.back().games++;
+    putVarint(raw, size);
+    raw.insert(raw.end(), log, log + size);
+}
+
+void ArchiveBlock::clear() {
+    raw.clear();
+    runs.clear();
+}
+
+GameArchiveWriter::~GameArchiveWriter() {
+    std::string error;
+    close(error);
+}
+
+bool GameArchiveWriter::open(const std::string& path, const std::string& description, std::string& error) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot create " + path;
+        return false;
+    }
+    filePath = path;
+    failure.clear();
+    closing = false;
+    numGames = 0;
+    totalRaw = 0;
+    blocks.clear();
+    runs.clear();
+
+    std::vector<uint8_t> header(MAGIC, MAGIC + 4);
+    putU32(header, VERSION);
+    putU32(header, static_cast<uint32_t>(description.size()));
+    header.insert(header.end(), description.begin(), description.end());
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+        failure = "could not write " + filePath;
+    }
+    offset = header.size();
+
+    compressor = std::thread([this] { compressLoop(); });
+    return true;
+}
+
+void GameArchiveWriter::write(ArchiveBlock& block) {
+    if (block.empty()) return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!file) {
+        block.clear();
+        return;
+    }
+    room.wait(lock, [this] { return pending.size() < MAX_PENDING; });
+
+    // The worker carries on with a block emptied by the compressor, so
+    // its buffers keep their capacity
+    ArchiveBlock next;
+    if (!spare.empty()) {
+        next = std::move(spare.back());
+        spare.pop_back();
+    }
+    pending.push_back(std::move(block));
+    block = std::move(next);
+    lock.unlock();
+    queued.notify_one();
+}
+
+void GameArchiveWriter::compressLoop() {
+    for (;;) {
+        ArchiveBlock block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queued.wait(lock, [this] { return closing || !pending.empty(); });
+            if (pending.empty()) return;
+            block = std::move(pending.front());
+            pending.pop_front();
+        }
+        room.notify_one();
+
+        store(block);
+        block.clear();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        spare.push_back(std::move(block));
+    }
+}
+
+void GameArchiveWriter::store(const ArchiveBlock& block) {
+    if (!failure.empty()) return;
+
+    // Logs to records, run by run; the runs follow each other in the block
+    encoded.clear();
+    const uint32_t index = static_cast<uint32_t>(blocks.size());
+    size_t pos = 0;
+    for (const ArchiveBlock::Run& run : block.runs) {
+        runs.push_back({run.firstGame, run.games, index, static_cast<uint32_t>(encoded.size())});
+        for (uint32_t game = 0; game < run.games; game++) {
+            uint64_t size = 0;
+            record.clear();
+            if (!getVarint(block.raw.data(), block.raw.size(), pos, size) || size > block.raw.size() - pos
+                || !encodeRecord(block.raw.data() + pos, size, record)) {
+                failure = "could not encode game " + std::to_string(run.firstGame + game);
+                return;
+            }
+            pos += size;
+            putVarint(encoded, record.size());
+            encoded.insert(encoded.end(), record.begin(), record.end());
+        }
+    }
+
+    huffman::compress(encoded, compressed);
+    const std::vector<uint8_t>& stored = compressed.size() < encoded.size() ? compressed : encoded;
+    if (std::fwrite(stored.data(), 1, stored.size(), file) != stored.size()) {
+        failure = "could not write " + filePath;
+        return;
+    }
+    blocks.push_back({offset, static_cast<uint32_t>(stored.size()), static_cast<uint32_t>(encoded.size())});
+    for (const ArchiveBlock::Run& run : block.runs) {
+        numGames += run.games;
+    }
+    offset += stored.size();
+    totalRaw += encoded.size();
+}
+
+bool GameArchiveWriter::close(std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file) return true;
+        closing = true;
+    }
+    queued.notify_one();
+    compressor.join();
+
+    std::sort(runs.begin(), runs.end(),
+              [](const RunEntry& a, const RunEntry& b) { return a.firstGame < b.firstGame; });
+
+    std::vector<uint8_t> index;
+    index.reserve(runs.size() * RUN_ENTRY_SIZE + blocks.size() * BLOCK_ENTRY_SIZE + FOOTER_SIZE);
+    uint64_t runsOffset = offset;
+    for (const RunEntry& run : runs) {
+        putU64(index, run.firstGame);
+        putU32(index, run.games);
+        putU32(index, run.block);
+        putU32(index, run.offset);
+    }
+    uint64_t blocksOffset = offset + index.size();
+    for (const BlockEntry& block : blocks) {
+        putU64(index, block.offset);
+        putU32(index, block.storedSize);
+        putU32(index, block.rawSize);
+    }
+    putU64(index, runsOffset);
+    putU64(index, runs.size());
+    putU64(index, blocksOffset);
+    putU64(index, blocks.size());
+    putU64(index, numGames);
+    index.insert(index.end(), MAGIC, MAGIC + 4);
+    putU32(index, VERSION);
+
+    if (std::fwrite(index.data(), 1, index.size(), file) != index.size() && failure.empty()) {
+        failure = "could not write " + filePath;
+    }
+    offset += index.size();
+    if (std::fclose(file) != 0 && failure.empty()) {
+        failure = "could not write " + filePath;
+    }
+    file = nullptr;
+
+    if (!failure.empty()) {
+        error = failure;
+        return false;
+    }
+    return true;
+}
+
+GameArchiveReader::~GameArchiveReader() {
+    unmap();
+}
+
+void GameArchiveReader::unmap() {
+#ifdef _WIN32
+    if (mapped) UnmapViewOfFile(mapped);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (mapped) munmap(const_cast<uint8_t*>(mapped), mappedSize);
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+    cachedBlock = UINT64_MAX;
+}
+
+bool GameArchiveReader::open(const std::string& path, std::string& error) {
+    unmap();
+    error = "cannot open " + path;
+
+#ifdef _WIN32
+    HANDLE fileH = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileH == INVALID_HANDLE_VALUE) return false;
+    fileHandle = fileH;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileH, &fileSize) || fileSize.QuadPart == 0) {
+        unmap();
+        return false;
+    }
+    HANDLE mappingH = CreateFileMappingA(fileH, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingH) {
+        unmap();
+        return false;
+    }
+    mappingHandle = mappingH;
+    mapped = static_cast<const uint8_t*>(MapViewOfFile(mappingH, FILE_MAP_READ, 0, 0, 0));
+    if (!mapped) {
+        unmap();
+        return false;
+    }
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) return false;
+    mapped = static_cast<const uint8_t*>(address);
+    mappedSize = static_cast<size_t>(info.st_size);
+#endif
+
+    error = path + " is not a complete game archive";
+    if (mappedSize < HEADER_SIZE + FOOTER_SIZE || std::memcmp(mapped, MAGIC, 4) != 0) {
+        unmap();
+        return false;
+    }
+    const uint8_t* footer = mapped + mappedSize - FOOTER_SIZE;
+    if (std::memcmp(footer + 40, MAGIC, 4) != 0 || getU32(footer + 44) != VERSION) {
+        unmap();
+        return false;
+    }
+
+    uint32_t descriptionSize = getU32(mapped + 8);
+    uint64_t runsOffset = getU64(footer);
+    numRuns = getU64(footer + 8);
+    uint64_t blocksOffset = getU64(footer + 16);
+    numBlocks = getU64(footer + 24);
+    numGames = getU64(footer + 32);
+
+    // The tables must lie between the header and the footer
+    uint64_t indexEnd = mappedSize - FOOTER_SIZE;
+    if (descriptionSize > indexEnd - HEADER_SIZE || runsOffset < HEADER_SIZE + descriptionSize ||
+        runsOffset > indexEnd || numRuns > (indexEnd - runsOffset) / RUN_ENTRY_SIZE ||
+        blocksOffset != runsOffset + numRuns * RUN_ENTRY_SIZE ||
+        numBlocks > (indexEnd - blocksOffset) / BLOCK_ENTRY_SIZE) {
+        unmap();
+        return false;
+    }
+
+    header.assign(reinterpret_cast<const char*>(mapped + HEADER_SIZE), descriptionSize);
+    runTable = mapped + runsOffset;
+    blockTable = mapped + blocksOffset;
+    error.clear();
+    return true;
+}
+
+bool GameArchiveReader::loadBlock(uint64_t block, std::string& error) {
+    if (block == cachedBlock) return true;
+
+    const uint8_t* entry = blockTable + block * BLOCK_ENTRY_SIZE;
+    uint64_t start = getU64(entry);
+    uint32_t storedSize = getU32(entry + 8);
+    uint32_t rawSize = getU32(entry + 12);
+    uint64_t blocksEnd = static_cast<uint64_t>(runTable - mapped);
+    if (start > blocksEnd || storedSize > blocksEnd - start) {
+        error = "block " + std::to_string(block) + " lies outside the archive";
+        return false;
+    }
+
+    cachedBlock = UINT64_MAX;
+    blockData.resize(rawSize);
+    if (storedSize == rawSize) {
+        std::memcpy(blockData.data(), mapped + start, rawSize);
+    } else if (!huffman::decompress(mapped + start, storedSize, blockData)) {
+        error = "block " + std::to_string(block) + " is damaged";
+        return false;
+    }
+    cachedBlock = block;
+    return true;
+}
+
+bool GameArchiveReader::find(uint64_t game, std::vector<uint8_t>& record, std::string& error) {
+    if (!mapped) {
+        error = "no archive open";
+        return false;
+    }
+
+    // Last run starting at or before the game
+    uint64_t low = 0, high = numRuns;
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        if (getU64(runTable + middle * RUN_ENTRY_SIZE) <= game) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    const uint8_t* run = low ? runTable + (low - 1) * RUN_ENTRY_SIZE : nullptr;
+    if (!run || game - getU64(run) >= getU32(run + 8)) {
+        error = "game " + std::to_string(game) + " is not in the archive";
+        return false;
+    }
+
+    uint32_t block = getU32(run + 12);
+    if (block >= numBlocks) {
+        error = "run of game " + std::to_string(game) + " points past the block table";
+        return false;
+    }
+    if (!loadBlock(block, error)) return false;
+
+    // Skip the records before the game in its run
+    size_t pos = getU32(run + 16);
+    uint64_t size = 0;
+    for (uint64_t skip = game - getU64(run); ; skip--) {
+        if (!getVarint(blockData.data(), blockData.size(), pos, size) || size > blockData.size() - pos) {
+            error = "block " + std::to_string(block) + " is damaged";
+            return false;
+        }
+        if (skip == 0) break;
+        pos += size;
+    }
+    record.assign(blockData.begin() + pos, blockData.begin() + pos + size);
+    return true;
+}
+
+} // namespace sevens
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sevens {
+
+// Game logs (GameRecorder) waiting to be written to a GameArchiveWriter,
+// one block per worker
+class ArchiveBlock {
+public:
+    // Log bytes a block holds before it is handed to the writer
+    static const size_t BLOCK_SIZE = 256 * 1024;
+
+    struct Run {
+        uint64_t firstGame;
+        uint32_t games;
+        uint32_t offset;    // of the first game's log in the block
+    };
+
+    void add(uint64_t game, const uint8_t* log, size_t size);
+    bool full() const { return raw.size() >= BLOCK_SIZE; }
+    bool empty() const { return raw.empty(); }
+    void clear();
+
+private:
+    friend class GameArchiveWriter;
+
+    std::vector<uint8_t> raw;
+    std::vector<Run> runs;
+};
+
+/**
+ * Archive of game records (GameRecord.hpp), numbered by game.
+ *
+ * Simulation workers gather game logs into blocks of about BLOCK_SIZE
+ * bytes and hand each full block to the writer, which swaps it for an
+ * empty one. The writer's compressor thread turns every log into its
+ * record (encodeRecord), prefixed by its length (a varint), compresses
+ * the block with a Huffman code of its byte values (about half the raw
+ * size for game records) and appends it to the file; a block that does
+ * not shrink is stored as is. The workers are left with nothing to do
+ * per turn but log it. At most MAX_PENDING blocks wait for the
+ * compressor; a worker handing over one more waits for room.
+ *
+ * The file is
+ *     header:  "SVGA", version, description length, description
+ *     blocks
+ *     runs:    first game, game count, block, offset in the block
+ *     blocks:  file offset, stored size, raw size
+ *     footer:  run table offset and count, block table offset and
+ *              count, number of games, "SVGA", version
+ * with every integer little-endian. A run is a series of consecutively
+ * numbered games stored one after the other in a block, and the run
+ * table is sorted by game. Finding a game is a binary search of the run
+ * table in the memory-mapped file and the decompression of a single
+ * block, whatever the size of the archive.
+ */
+class GameArchiveWriter {
+public:
+    GameArchiveWriter() = default;
+    ~GameArchiveWriter();
+    GameArchiveWriter(const GameArchiveWriter&) = delete;
+    GameArchiveWriter& operator=(const GameArchiveWriter&) = delete;
+
+    // Create the file; `description` is stored in the header (for example
+    // the strategies in each seat)
+    bool open(const std::string& path, const std::string& description, std::string& error);
+
+    // Queue the block for the compressor thread and leave `block` empty;
+    // safe to call from several threads at once
+    void write(ArchiveBlock& block);
+
+    // Wait for the queued blocks and write the index; false if any
+    // record or write failed
+    bool close(std::string& error);
+
+    uint64_t games() const { return numGames; }
+    uint64_t rawBytes() const { return totalRaw; }
+    uint64_t fileBytes() const { return offset; }
+
+private:
+    struct BlockEntry {
+        uint64_t offset;
+        uint32_t storedSize;
+        uint32_t rawSize;
+    };
+    struct RunEntry {
+        uint64_t firstGame;
+        uint32_t games;
+        uint32_t block;
+        uint32_t offset;
+    };
+
+    // Full blocks queued at once
+    static const size_t MAX_PENDING = 8;
+
+    std::FILE* file = nullptr;
+    std::string filePath;
+
+    // Blocks handed over by write() and emptied ones to hand back
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable room;
+    std::deque<ArchiveBlock> pending;
+    std::vector<ArchiveBlock> spare;
+    bool closing = false;
+    std::thread compressor;
+
+    // Used by the compressor thread only, until close() joins it
+    std::string failure;
+    uint64_t offset = 0;
+    uint64_t numGames = 0;
+    uint64_t totalRaw = 0;
+    std::vector<BlockEntry> blocks;
+    std::vector<RunEntry> runs;
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> record;
+    std::vector<uint8_t> compressed;
+
+    void compressLoop();
+    void store(const ArchiveBlock& block);
+};
+
+// Lookups of single games in a finished archive, which is memory-mapped
+class GameArchiveReader {
+public:
+    GameArchiveReader() = default;
+    ~GameArchiveReader();
+    GameArchiveReader(const GameArchiveReader&) = delete;
+    GameArchiveReader& operator=(const GameArchiveReader&) = delete;
+
+    // Map the file and check its footer; false (with `error` set) if it
+    // is not a complete archive
+    bool open(const std::string& path, std::string& error);
+
+    // Copy the record of `game` into `record`; false (with `error` set)
+    // if the archive does not hold the game or its block is damaged
+    bool find(uint64_t game, std::vector<uint8_t>& record, std::string& error);
+
+    uint64_t games() const { return numGames; }
+    uint64_t blockCount() const { return numBlocks; }
+    const std::string& description() const { return header; }
+
+private:
+    const uint8_t* mapped = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    std::string header;
+    const uint8_t* runTable = nullptr;
+    const uint8_t* blockTable = nullptr;
+    uint64_t numRuns = 0;
+    uint64_t numBlocks = 0;
+    uint64_t numGames = 0;
+
+    // The last block decompressed, kept for lookups of nearby games
+    uint64_t cachedBlock = UINT64_MAX;
+    std::vector<uint8_t> blockData;
+
+    void unmap();
+    bool loadBlock(uint64_t block, std::string& error);
+};
+
+} // namespace sevens
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include "LegalMoves.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sevens {
+
+// Bytes and flags of the game log and record formats (see GameRecorder
+// and encodeRecord)
+namespace records {
+
+constexpr uint8_t PASS = 0x80;
+constexpr uint8_t END_OF_ROUND = 0xFF;
+constexpr uint8_t CUSTOM_DECK = 0x80;
+
+// Every card dealt with the standard deck
+constexpr CardMask STANDARD_DECK = bitboard::FULL_DECK & ~bitboard::cardMask(1, 7);
+
+// Bit planes of a deal: bits per seat index
+inline int seatBits(uint64_t numSeats) {
+    return numSeats <= 2 ? 1 : numSeats <= 4 ? 2 : numSeats <= 8 ? 3 : 4;
+}
+
+// Number of cards in a mask, with shifts and masks: the engine is
+// built without a popcount instruction, and the library call it falls
+// back on would be most of the cost of encoding a turn
+inline uint8_t countBits(CardMask mask) {
+    mask -= (mask >> 1) & 0x5555555555555555ULL;
+    mask = (mask & 0x3333333333333333ULL) + ((mask >> 2) & 0x3333333333333333ULL);
+    mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<uint8_t>((mask * 0x0101010101010101ULL) >> 56);
+}
+
+// The 13 ranks of every suit of a mask, side by side, and back
+constexpr int ROW_BITS = 52;
+
+inline uint64_t packRows(CardMask mask) {
+    return bitboard::suitRanks(mask, 0) | uint64_t(bitboard::suitRanks(mask, 1)) << 13 |
+           uint64_t(bitboard::suitRanks(mask, 2)) << 26 | uint64_t(bitboard::suitRanks(mask, 3)) << 39;
+}
+
+inline CardMask unpackRows(uint64_t rows) {
+    CardMask mask = 0;
+    for (int suit = 0; suit < 4; suit++) {
+        mask |= ((rows >> (13 * suit)) & 0x1FFF) << (suit * bitboard::SUIT_SHIFT + 1);
+    }
+    return mask;
+}
+
+} // namespace records
+
+/**
+ * Log of one game, written by MyGameMapper while it plays (see
+ * MyGameMapper::setRecorder) and turned into a record by encodeRecord.
+ *
+ * The log is one byte holding the number of seats, then for every round
+ * the hand of each seat as dealt (8 bytes, little-endian), one byte per
+ * turn in seat order from seat 0 (the card bit played, or PASS; a
+ * rejected move is logged as the pass it counts as) and END_OF_ROUND.
+ * Logging a turn is a single append to a buffer that keeps its capacity
+ * from game to game, so recording adds almost no work to the round loop
+ * and no allocations once the buffer has grown to the longest game: the
+ * legal move indices and bit planes of the record are worked out later by
+ * encodeRecord, on the archive's compressor thread (GameArchive.hpp).
+ */
+class GameRecorder {
+public:
+    // Reserves the buffer on first use, before the round loop starts
+    void beginGame(uint64_t seats) {
+        if (buffer.size() < INITIAL_CAPACITY) {
+            buffer.resize(INITIAL_CAPACITY);
+        }
+        length = 0;
+        buffer[length++] = static_cast<uint8_t>(seats);
+    }
+
+    void beginRound(const std::vector<CardMask>& hands) {
+        for (CardMask hand : hands) {
+            for (int i = 0; i < 8; i++) {
+                append(static_cast<uint8_t>(hand >> (8 * i)));
+            }
+        }
+    }
+
+    void play(int cardBit) { append(static_cast<uint8_t>(cardBit)); }
+    void pass() { append(records::PASS); }
+    void endRound() { append(records::END_OF_ROUND); }
+
+    const uint8_t* data() const { return buffer.data(); }
+    size_t size() const { return length; }
+
+private:
+    // A few times the size of a long game
+    static const size_t INITIAL_CAPACITY = 32 * 1024;
+
+    std::vector<uint8_t> buffer;
+    size_t length = 0;
+
+    // A round has no bound on its turns (a seat may pass while holding a
+    // legal card), so the buffer doubles when it is full
+    void append(uint8_t byte) {
+        if (length == buffer.size()) {
+            buffer.resize(2 * buffer.size());
+        }
+        buffer[length++] = byte;
+    }
+};
+
+/**
+ * Compact binary record of one game, from its GameRecorder log.
+ *
+ * A record starts with one byte holding the number of seats. If the
+ * deck is not the standard 51 cards (the 7 of Diamonds starts on the
+ * table), bit 7 of that byte is set and the 8-byte deck mask follows,
+ * little-endian. Every round is then:
+ * - the deal: the seat index of every card, in 1 to 4 bit planes (two
+ *   for three or four seats). Plane b has bit b of the index of each
+ *   card, as the 13-rank rows of the four suits (52 bits, the 7 of
+ *   Diamonds included), and planes are packed LSB first, so a deal
+ *   takes 13 bytes for three or four seats;
+ * - one byte per turn, in seat order from seat 0: the index of the card
+ *   played among the seat's legal moves in bit order (below
+ *   moves::MAX_PLAYABLE), or PASS;
+ * - END_OF_ROUND.
+ *
+ * Legal move indices are mostly 0 to 2, which the archive's compressor
+ * shrinks far better than card bits; the decoder replays the table to
+ * turn them back into cards. The record is appended to `out`; false
+ * (with `out` unchanged) if the log is truncated or plays a card that
+ * was not legal.
+ */
+inline bool encodeRecord(const uint8_t* log, size_t size, std::vector<uint8_t>& out) {
+    if (size == 0) return false;
+    const uint64_t numSeats = log[0];
+    if (numSeats < 1 || numSeats > 16) return false;
+
+    // A record is at most 8 bytes longer than its log (the deck mask)
+    const size_t start = out.size();
+    out.resize(start + size + 8);
+    uint8_t* dst = out.data() + start;
+    auto fail = [&] {
+        out.resize(start);
+        return false;
+    };
+
+    const int bits = records::seatBits(numSeats);
+    const size_t dealBytes = 8 * numSeats;
+    CardMask hands[16];
+    size_t pos = 1;
+    bool first = true;
+    while (pos < size) {
+        if (size - pos < dealBytes) return fail();
+        CardMask dealt = 0;
+        for (uint64_t seat = 0; seat < numSeats; seat++) {
+            hands[seat] = 0;
+            for (int i = 0; i < 8; i++) {
+                hands[seat] |= CardMask(log[pos++]) << (8 * i);
+            }
+            dealt |= hands[seat];
+        }
+
+        // The header is written with the first deal, once the deck is known
+        if (first) {
+            first = false;
+            if (dealt == records::STANDARD_DECK) {
+                *dst++ = static_cast<uint8_t>(numSeats);
+            } else {
+                *dst++ = static_cast<uint8_t>(numSeats) | records::CUSTOM_DECK;
+                for (int i = 0; i < 8; i++) {
+                    *dst++ = static_cast<uint8_t>(dealt >> (8 * i));
+                }
+            }
+        }
+
+        CardMask planes[4] = {};
+        for (uint64_t seat = 0; seat < numSeats; seat++) {
+            for (int b = 0; b < bits; b++) {
+                if (seat >> b & 1) planes[b] |= hands[seat];
+            }
+        }
+        uint64_t pending = 0;
+        int used = 0;
+        for (int b = 0; b < bits; b++) {
+            pending |= records::packRows(planes[b]) << used;
+            used += records::ROW_BITS;
+            while (used >= 8) {
+                *dst++ = static_cast<uint8_t>(pending);
+                pending >>= 8;
+                used -= 8;
+            }
+        }
+        if (used > 0) {
+            *dst++ = static_cast<uint8_t>(pending);
+        }
+
+        // Replay the turns to find the legal move index of each card.
+        // Passes and plays alternate at random, so both go through the
+        // same straight-line code (a pass plays no card)
+        CardMask table = bitboard::cardMask(1, 7);
+        uint64_t seat = 0;
+        while (pos < size && log[pos] != records::END_OF_ROUND) {
+            uint8_t move = log[pos++];
+            if (move >= 64 && move != records::PASS) return fail();
+            CardMask card = CardMask(move < 64) << (move & 63);
+            CardMask legal = moves::legalMoves(hands[seat], table);
+            if (card & ~legal) return fail();
+            *dst++ = card ? records::countBits(legal & (card - 1)) : records::PASS;
+            hands[seat] &= ~card;
+            table |= card;
+            seat = seat + 1 == numSeats ? 0 : seat + 1;
+        }
+        if (pos == size) return fail();
+        pos++;
+        *dst++ = records::END_OF_ROUND;
+    }
+    out.resize(dst - out.data());
+    return true;
+}
+
+// A record decoded back into hands and turns
+struct RecordedRound {
+    std::vector<CardMask> hands;    // by seat, as dealt
+    std::vector<uint8_t> moves;     // turn t is seat t % seats: card bit played or records::PASS
+};
+
+struct RecordedGame {
+    uint64_t numSeats = 0;
+    CardMask deck = 0;
+    std::vector<RecordedRound> rounds;
+};
+
+// Decode a record; false if it is truncated or malformed
+inline bool decodeGame(const uint8_t* data, size_t size, RecordedGame& game) {
+    game = RecordedGame();
+    if (size == 0) return false;
+
+    size_t pos = 0;
+    uint8_t header = data[pos++];
+    game.numSeats = header & ~records::CUSTOM_DECK;
+    game.deck = records::STANDARD_DECK;
+    if (header & records::CUSTOM_DECK) {
+        if (size - pos < 8) return false;
+        game.deck = 0;
+        for (int i = 0; i < 8; i++) {
+            game.deck |= CardMask(data[pos++]) << (8 * i);
+        }
+    }
+    if (game.numSeats < 1 || game.numSeats > 16) return false;
+
+    const int bits = records::seatBits(game.numSeats);
+    const size_t dealBytes = (bits * records::ROW_BITS + 7) / 8;
+    while (pos < size) {
+        if (size - pos < dealBytes) return false;
+        RecordedRound round;
+        round.hands.assign(game.numSeats, 0);
+
+        uint64_t pending = 0;
+        int available = 0;
+        CardMask planes[4] = {};
+        for (int b = 0; b < bits; b++) {
+            while (available < records::ROW_BITS) {
+                pending |= uint64_t(data[pos++]) << available;
+                available += 8;
+            }
+            planes[b] = records::unpackRows(pending & ((uint64_t(1) << records::ROW_BITS) - 1));
+            pending >>= records::ROW_BITS;
+            available -= records::ROW_BITS;
+        }
+        CardMask claimed = 0;
+        for (uint64_t seat = 0; seat < game.numSeats; seat++) {
+            CardMask hand = game.deck;
+            for (int b = 0; b < bits; b++) {
+                hand &= (seat >> b & 1) ? planes[b] : ~planes[b];
+            }
+            round.hands[seat] = hand;
+            claimed |= hand;
+        }
+        if (claimed != game.deck) return false;
+
+        // Replay the turns to find the cards behind the move indices
+        std::vector<CardMask> hands = round.hands;
+        CardMask table = bitboard::cardMask(1, 7);
+        for (uint64_t turn = 0; pos < size && data[pos] != records::END_OF_ROUND; turn++) {
+            uint8_t move = data[pos++];
+            if (move != records::PASS) {
+                CardMask& hand = hands[turn % game.numSeats];
+                CardMask legal = moves::legalMoves(hand, table);
+                if (move >= bitboard::popcount(legal)) return false;
+                for (uint8_t skip = 0; skip < move; skip++) {
+                    legal &= legal - 1;
+                }
+                move = static_cast<uint8_t>(bitboard::lowestBit(legal));
+                hand &= ~(CardMask(1) << move);
+                table |= CardMask(1) << move;
+            }
+            round.moves.push_back(move);
+        }
+        if (pos == size) return false;
+        pos++;
+        game.rounds.push_back(std::move(round));
+    }
+    return true;
+}
+
+} // namespace sevens
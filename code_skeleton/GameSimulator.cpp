@@ -0,0 +1,334 @@
+// GameSimulator.cpp
+#include "GameSimulator.hpp"
+#include "AllocationCounter.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace sevens {
+
+void SimulationStats::resize(size_t seats) {
+    // The pair tables are indexed by the seat count: move the counts
+    if (seats != names.size()) {
+        std::vector<uint64_t> wins(seats * seats, 0), tied(seats * seats, 0);
+        for (size_t a = 0; a < names.size() && a < seats; a++) {
+            for (size_t b = 0; b < names.size() && b < seats; b++) {
+                wins[a * seats + b] = pairWins[a * names.size() + b];
+                tied[a * seats + b] = pairTies[a * names.size() + b];
+            }
+        }
+        pairWins.swap(wins);
+        pairTies.swap(tied);
+    }
+    names.resize(seats);
+    gamesWon.resize(seats, 0);
+    roundsWon.resize(seats, 0);
+    cardsLeft.resize(seats, 0);
+}
+
+void SimulationStats::merge(const SimulationStats& other) {
+    resize(std::max(names.size(), other.names.size()));
+    games += other.games;
+    totalRounds += other.totalRounds;
+    steadyRounds += other.steadyRounds;
+    steadyAllocations += other.steadyAllocations;
+    for (size_t seat = 0; seat < other.names.size(); seat++) {
+        names[seat] = other.names[seat];
+        gamesWon[seat] += other.gamesWon[seat];
+        roundsWon[seat] += other.roundsWon[seat];
+        cardsLeft[seat] += other.cardsLeft[seat];
+        for (size_t opponent = 0; opponent < other.names.size(); opponent++) {
+            pairWins[seat * names.size() + opponent] += other.wins(seat, opponent);
+            pairTies[seat * names.size() + opponent] += other.ties(seat, opponent);
+        }
+    }
+}
+
+GameSimulator::GameSimulator(const MyGameMapper& prototypeEngine, std::vector<StrategyFactory> seatFactories)
+    : prototype(prototypeEngine), factories(std::move(seatFactories)) {
+}
+
+GameSimulator::Worker GameSimulator::makeWorker() const {
+    Worker worker;
+    worker.engine = prototype;
+    worker.stats.resize(factories.size());
+    for (uint64_t seat = 0; seat < factories.size(); seat++) {
+        std::shared_ptr<PlayerStrategyV2> strategy = factories[seat]();
+        worker.stats.names[seat] = strategy->getName();
+        worker.strategies.push_back(strategy);
+    }
+    return worker;
+}
+
+void GameSimulator::playGame(Worker& worker, uint64_t seed, uint64_t deal, const int* order, uint64_t* cards) const {
+    MyGameMapper& engine = worker.engine;
+    SimulationStats& stats = worker.stats;
+    uint64_t numSeats = worker.strategies.size();
+    auto strategyAt = [order](uint64_t seat) -> uint64_t {
+        return order ? static_cast<uint64_t>(order[seat]) : seat;
+    };
+
+    // Every game starts from the same state whichever worker runs it:
+    // its own random stream and freshly initialized strategies
+    engine.setRandomStream(RngStream(seed).derive(deal));
+    for (uint64_t seat = 0; seat < numSeats; seat++) {
+        engine.registerStrategyV2(seat, worker.strategies[strategyAt(seat)]);
+    }
+
+    engine.compute_game_progress(numSeats);
+
+    uint64_t best = UINT64_MAX;
+    for (uint64_t seat = 0; seat < numSeats; seat++) {
+        best = std::min(best, engine.getTotalCards(seat));
+    }
+
+    for (uint64_t seat = 0; seat < numSeats; seat++) {
+        uint64_t left = engine.getTotalCards(seat);
+        uint64_t player = strategyAt(seat);
+        stats.cardsLeft[player] += left;
+        stats.roundsWon[player] += engine.getRoundsWon(seat);
+        if (left == best) {
+            stats.gamesWon[player]++;
+        }
+        if (cards) {
+            cards[player] = left;
+        }
+        for (uint64_t opponent = 0; opponent < numSeats; opponent++) {
+            uint64_t theirs = engine.getTotalCards(opponent);
+            if (left < theirs) {
+                stats.pairWins[player * numSeats + strategyAt(opponent)]++;
+            } else if (left == theirs && opponent != seat) {
+                stats.pairTies[player * numSeats + strategyAt(opponent)]++;
+            }
+        }
+    }
+
+    stats.totalRounds += engine.getTotalRounds();
+    stats.steadyRounds += engine.getTotalRounds() - 1;
+    stats.steadyAllocations += engine.getSteadyStateAllocations();
+    stats.games++;
+}
+
+SimulationStats GameSimulator::run(uint64_t numGames, uint64_t seed, unsigned numThreads,
+                                   std::vector<uint64_t>* gameCards) {
+    return runGames(numGames, seed, numThreads, gameCards, {});
+}
+
+uint64_t GameSimulator::seatOrders() const {
+    uint64_t orders = 1;
+    for (uint64_t n = 2; n <= factories.size(); n++) {
+        orders *= n;
+    }
+    return orders;
+}
+
+void GameSimulator::setArchive(GameArchiveWriter* gameArchive) {
+    archive = gameArchive;
+}
+
+SimulationStats GameSimulator::runDuplicate(uint64_t numDeals, uint64_t seed, unsigned numThreads,
+                                            std::vector<uint64_t>* gameCards) {
+    std::vector<std::vector<int>> orders;
+    std::vector<int> order(factories.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<int>(i);
+    }
+    do {
+        orders.push_back(order);
+    } while (std::next_permutation(order.begin(), order.end()));
+
+    return runGames(numDeals * orders.size(), seed, numThreads, gameCards, orders);
+}
+
+SimulationStats GameSimulator::runGames(uint64_t numGames, uint64_t seed, unsigned numThreads,
+                                        std::vector<uint64_t>* gameCards,
+                                        const std::vector<std::vector<int>>& orders) {
+    // No seats, no games (printStats reports it)
+    if (factories.empty()) {
+        return SimulationStats();
+    }
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    uint64_t numChunks = (numGames + GAMES_PER_CHUNK - 1) / GAMES_PER_CHUNK;
+    numThreads = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(numThreads, numChunks)));
+
+    // Each game writes its own slots, so workers never share one
+    const uint64_t numSeats = factories.size();
+    if (gameCards) {
+        gameCards->assign(numGames * numSeats, 0);
+    }
+
+    // Engines and strategy instances are never shared between threads
+    std::vector<Worker> workers;
+    for (unsigned t = 0; t < numThreads; t++) {
+        workers.push_back(makeWorker());
+    }
+
+    std::atomic<uint64_t> nextChunk{0};
+    auto work = [&](Worker& worker) {
+        worker.engine.setRecorder(archive ? &worker.recorder : nullptr);
+        for (;;) {
+            uint64_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= numChunks) break;
+
+            uint64_t end = std::min(numGames, (chunk + 1) * GAMES_PER_CHUNK);
+            for (uint64_t game = chunk * GAMES_PER_CHUNK; game < end; game++) {
+                uint64_t* cards = gameCards ? gameCards->data() + game * numSeats : nullptr;
+                if (orders.empty()) {
+                    playGame(worker, seed, game, nullptr, cards);
+                } else {
+                    playGame(worker, seed, game / orders.size(), orders[game % orders.size()].data(), cards);
+                }
+                if (archive) {
+                    worker.block.add(game, worker.recorder.data(), worker.recorder.size());
+                    if (worker.block.full()) {
+                        archive->write(worker.block);
+                    }
+                }
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < numThreads; t++) {
+        threads.emplace_back(work, std::ref(workers[t]));
+    }
+    work(workers[0]);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    if (archive) {
+        for (Worker& worker : workers) {
+            archive->write(worker.block);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Counters are integers, so the merged result does not depend on
+    // which worker played which game
+    SimulationStats stats;
+    for (const Worker& worker : workers) {
+        stats.merge(worker.stats);
+    }
+    stats.seconds = seconds;
+    stats.threads = numThreads;
+    return stats;
+}
+
+void GameSimulator::printStats(const SimulationStats& stats, std::ostream& os) {
+    if (stats.games == 0) {
+        os << "No games played\n";
+        return;
+    }
+
+    double games = static_cast<double>(stats.games);
+    double gamesPerSec = stats.seconds > 0.0 ? games / stats.seconds : 0.0;
+
+    os << "\n=================================\n";
+    os << "SIMULATION RESULTS (" << stats.games << " games)\n";
+    os << "=================================\n";
+    os << std::fixed << std::setprecision(1);
+    os << "Time: " << stats.seconds << " s (" << gamesPerSec << " games/sec, "
+       << stats.threads << " threads)\n";
+    os << std::setprecision(2);
+    os << "Average rounds per game: " << stats.totalRounds / games << "\n";
+    if (allocations::ENABLED && stats.steadyRounds > 0) {
+        os << "Steady-state allocations per round: "
+           << static_cast<double>(stats.steadyAllocations) / stats.steadyRounds << "\n";
+    }
+
+    for (size_t seat = 0; seat < stats.names.size(); seat++) {
+        double winRate = 100.0 * stats.gamesWon[seat] / games;
+        double roundRate = stats.totalRounds > 0
+            ? 100.0 * stats.roundsWon[seat] / stats.totalRounds : 0.0;
+
+        os << "Player " << seat << " (" << stats.names[seat] << ")\n";
+        os << "    Games Won: " << stats.gamesWon[seat] << "/" << stats.games
+           << " (" << std::setprecision(1) << winRate << "%)\n";
+        os << "    Rounds Won: " << roundRate << "%\n";
+        os << "    Average Cards Left: " << std::setprecision(2)
+           << stats.cardsLeft[seat] / games << " per game\n";
+    }
+    os << "(ties for the lowest total count as a win for each tied player)\n";
+}
+
+void GameSimulator::printDuplicate(const SimulationStats& stats, const std::vector<uint64_t>& gameCards,
+                                   uint64_t gamesPerDeal, std::ostream& os) {
+    const size_t numStrategies = stats.names.size();
+    const uint64_t numDeals = gamesPerDeal && numStrategies ? gameCards.size() / numStrategies / gamesPerDeal : 0;
+    if (numDeals < 2) {
+        os << "Not enough deals for duplicate scores\n";
+        return;
+    }
+    const double games = static_cast<double>(numDeals * gamesPerDeal);
+
+    // Per deal: each strategy's average over the seat orders, minus the
+    // average of all strategies on that deal
+    std::vector<double> sum(numStrategies, 0.0), sumSquares(numStrategies, 0.0);
+    std::vector<double> rawSum(numStrategies, 0.0), rawSquares(numStrategies, 0.0);
+    std::vector<double> dealMean(numStrategies);
+    for (uint64_t deal = 0; deal < numDeals; deal++) {
+        std::fill(dealMean.begin(), dealMean.end(), 0.0);
+        for (uint64_t order = 0; order < gamesPerDeal; order++) {
+            const uint64_t* cards = &gameCards[(deal * gamesPerDeal + order) * numStrategies];
+            for (size_t s = 0; s < numStrategies; s++) {
+                double left = static_cast<double>(cards[s]);
+                dealMean[s] += left / gamesPerDeal;
+                rawSum[s] += left;
+                rawSquares[s] += left * left;
+            }
+        }
+        double field = 0.0;
+        for (double mean : dealMean) {
+            field += mean / numStrategies;
+        }
+        for (size_t s = 0; s < numStrategies; s++) {
+            double relative = dealMean[s] - field;
+            sum[s] += relative;
+            sumSquares[s] += relative * relative;
+        }
+    }
+
+    os << "\n=================================\n";
+    os << "DUPLICATE SCORES (" << numDeals << " deals x " << gamesPerDeal << " seat orders)\n";
+    os << "=================================\n";
+    os << "Cards left per game relative to the field on the same deals (lower is better)\n";
+    os << std::fixed << std::setprecision(2);
+    // Average over the strategies whose relative score varies at all
+    double gain = 0.0;
+    size_t gains = 0;
+    for (size_t s = 0; s < numStrategies; s++) {
+        double mean = sum[s] / numDeals;
+        double variance = std::max(0.0, (sumSquares[s] - numDeals * mean * mean) / (numDeals - 1));
+        double margin = 1.959964 * std::sqrt(variance / numDeals);
+
+        // The same games scored one by one, as if every deal were new
+        double rawMean = rawSum[s] / games;
+        double rawVariance = std::max(0.0, (rawSquares[s] - games * rawMean * rawMean) / (games - 1));
+        double rawMargin = 1.959964 * std::sqrt(rawVariance / games);
+        if (margin > 0.0) {
+            gain += (rawMargin / margin) * (rawMargin / margin);
+            gains++;
+        }
+
+        os << "Player " << s << " (" << stats.names[s] << "): " << std::showpos << mean << std::noshowpos
+           << " +- " << margin << " (unpaired +- " << rawMargin << ")\n";
+    }
+    if (gains > 0) {
+        os << std::setprecision(1) << "Scoring against the same deals needs about " << gain / gains
+           << "x fewer games for the same interval\n";
+    } else {
+        os << "Scoring against the same deals: gain n/a (no strategy's score varies from deal to deal)\n";
+    }
+    os << std::defaultfloat;
+}
+
+} // namespace sevens
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "GameArchive.hpp"
+#include "MyGameMapper.hpp"
+#include "PlayerStrategyV2.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace sevens {
+
+// Creates a fresh strategy instance for one seat
+typedef std::function<std::shared_ptr<PlayerStrategyV2>()> StrategyFactory;
+
+/**
+ * Aggregate results of a batch of headless games.
+ * All counters are per seat (seat = player ID).
+ */
+struct SimulationStats {
+    uint64_t games = 0;
+    uint64_t totalRounds = 0;
+    std::vector<std::string> names;
+    std::vector<uint64_t> gamesWon;    // lowest total at game end (ties count for each tied seat)
+    std::vector<uint64_t> roundsWon;
+    std::vector<uint64_t> cardsLeft;   // cards accumulated over whole games
+    std::vector<uint64_t> pairWins;    // [a * seats + b]: games a ended with fewer cards than b
+    std::vector<uint64_t> pairTies;    // [a * seats + b]: games a and b ended level (a != b)
+    uint64_t steadyRounds = 0;         // rounds after the first of each game
+    uint64_t steadyAllocations = 0;    // heap allocations made during those rounds
+    double seconds = 0.0;
+    unsigned threads = 1;
+
+    void resize(size_t seats);
+    void merge(const SimulationStats& other);
+
+    uint64_t wins(size_t a, size_t b) const { return pairWins[a * names.size() + b]; }
+    uint64_t ties(size_t a, size_t b) const { return pairTies[a * names.size() + b]; }
+};
+
+/**
+ * Runs many games without any per-turn output, spread over worker threads.
+ * Each worker copies a prototype engine that already holds the deck and
+ * table (so cards.txt is parsed once) and creates its own strategy
+ * instances; only aggregate statistics are kept and merged at the end.
+ *
+ * Game i always runs on the stream RngStream(seed).derive(i) (deals and
+ * seeded strategies) and starts with freshly initialized strategies, so
+ * results for a given seed do not depend on the number of threads.
+ *
+ * runDuplicate() replays every deal with the strategies in every seat
+ * order. The engine deals round r of a game from the game stream and r
+ * alone, so giving each replay the deal's stream gives every seat the
+ * same cards whoever sits there. Each strategy then plays every hand
+ * from every seat, and the luck of the deal cancels out when strategies
+ * are compared deal by deal (printDuplicate).
+ *
+ * With an archive set, every game is recorded (GameRecord.hpp) and
+ * stored under its game number. Workers only log the turns into blocks
+ * of their own; the archive's compressor thread encodes and compresses
+ * them.
+ */
+class GameSimulator {
+public:
+    GameSimulator(const MyGameMapper& prototypeEngine, std::vector<StrategyFactory> seatFactories);
+
+    // Play numGames games on numThreads threads (0 = all cores). With
+    // `gameCards`, the cards left of every seat after every game are kept
+    // too, at [game * seats + seat].
+    SimulationStats run(uint64_t numGames, uint64_t seed, unsigned numThreads = 0,
+                        std::vector<uint64_t>* gameCards = nullptr);
+
+    // Play each of numDeals deals once per seat order of the strategies.
+    // Counters are kept per strategy (the factory's index), and so are
+    // the `gameCards` slots; game g is order g % seatOrders() of deal
+    // g / seatOrders().
+    SimulationStats runDuplicate(uint64_t numDeals, uint64_t seed, unsigned numThreads = 0,
+                                 std::vector<uint64_t>* gameCards = nullptr);
+
+    // Games per deal in runDuplicate (the number of seat orders)
+    uint64_t seatOrders() const;
+
+    // Record the games of later runs into `archive` (null = stop
+    // recording); the caller closes it
+    void setArchive(GameArchiveWriter* archive);
+
+    static void printStats(const SimulationStats& stats, std::ostream& os);
+
+    // Cards left by each strategy relative to the field on the same deals,
+    // from the gameCards of runDuplicate, with 95% intervals, next to the
+    // interval the same games would give without the deal pairing
+    static void printDuplicate(const SimulationStats& stats, const std::vector<uint64_t>& gameCards,
+                               uint64_t gamesPerDeal, std::ostream& os);
+
+private:
+    // Games are handed out to workers in fixed-size chunks
+    static const uint64_t GAMES_PER_CHUNK = 64;
+
+    struct Worker {
+        MyGameMapper engine;
+        std::vector<std::shared_ptr<PlayerStrategyV2>> strategies;
+        SimulationStats stats;
+        GameRecorder recorder;
+        ArchiveBlock block;
+    };
+
+    Worker makeWorker() const;
+
+    // Play deal `deal` with strategy order[seat] in each seat (null =
+    // strategy i in seat i); counters go to the strategies
+    void playGame(Worker& worker, uint64_t seed, uint64_t deal, const int* order, uint64_t* cards) const;
+
+    // Game g is deal g with the seats in order, or with `orders` given,
+    // deal g / orders.size() in order g % orders.size()
+    SimulationStats runGames(uint64_t numGames, uint64_t seed, unsigned numThreads,
+                             std::vector<uint64_t>* gameCards, const std::vector<std::vector<int>>& orders);
+
+    MyGameMapper prototype;
+    std::vector<StrategyFactory> factories;
+    GameArchiveWriter* archive = nullptr;
+};
+
+} // namespace sevens
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include "LegalMoves.hpp"
+#include "PlayerStrategyV2.hpp"
+#include "RngStream.hpp"
+#include <array>
+#include <cstdint>
+
+namespace sevens {
+
+/**
+ * Complete state of a round for search: every seat's hand, the table and
+ * the seat to move. Follows MyGameMapper's round rules: seats move in
+ * order, a seat without a legal card passes, and the round ends as soon
+ * as a hand is empty (or nobody can play any more).
+ *
+ * Moves are made and unmade in place (makeMove/unmakeMove, pass/unpass)
+ * so a search needs a single state.
+ */
+struct GameState {
+    static constexpr int MAX_SEATS = GameView::MAX_SEATS;
+
+    std::array<CardMask, MAX_SEATS> hands = {};
+    CardMask table = 0;
+    int numPlayers = 0;
+    int toMove = 0;
+
+    int nextSeat(int seat) const {
+        return seat + 1 == numPlayers ? 0 : seat + 1;
+    }
+
+    CardMask legalMoves() const {
+        return moves::legalMoves(hands[toMove], table);
+    }
+
+    CardMask allHands() const {
+        CardMask all = 0;
+        for (int seat = 0; seat < numPlayers; seat++) {
+            all |= hands[seat];
+        }
+        return all;
+    }
+
+    // Nobody can play: the round ends without a winner
+    bool blocked() const {
+        return moves::legalMoves(allHands(), table) == 0;
+    }
+
+    int cardsLeft(int seat) const {
+        return bitboard::popcount(hands[seat]);
+    }
+
+    // Play `bit` from the hand of the seat to move and pass the turn on.
+    // The round is over if that seat's hand is now empty.
+    void makeMove(int bit) {
+        CardMask card = CardMask(1) << bit;
+        hands[toMove] &= ~card;
+        table |= card;
+        toMove = nextSeat(toMove);
+    }
+
+    void unmakeMove(int bit, int seat) {
+        CardMask card = CardMask(1) << bit;
+        hands[seat] |= card;
+        table &= ~card;
+        toMove = seat;
+    }
+
+    void pass() {
+        toMove = nextSeat(toMove);
+    }
+
+    void unpass(int seat) {
+        toMove = seat;
+    }
+
+    // Uniformly chosen card of a non-empty set
+    static int randomCard(CardMask cards, RngStream& rng) {
+        for (int skip = rng.below(bitboard::popcount(cards)); skip > 0; skip--) {
+            cards &= cards - 1;
+        }
+        return bitboard::lowestBit(cards);
+    }
+
+    // Random legal moves until the round ends: a hand is empty, or every
+    // seat passes in turn (nobody can play)
+    void playRandomly(RngStream& rng) {
+        int passes = 0;
+        while (passes < numPlayers) {
+            CardMask legal = legalMoves();
+            if (!legal) {
+                pass();
+                passes++;
+                continue;
+            }
+            int mover = toMove;
+            makeMove(randomCard(legal, rng));
+            if (hands[mover] == 0) return;
+            passes = 0;
+        }
+    }
+
+    /**
+     * A view for strategies called through the version 1 interface, which
+     * does not say how many cards the others hold: the unseen cards are
+     * shared out evenly between the other seats.
+     */
+    static GameView guessView(CardMask hand, CardMask table, int seat, int numPlayers) {
+        GameView view = GameView{};
+        view.hand = hand;
+        view.table = table;
+        view.played = table & ~bitboard::cardMask(1, 7);
+        view.numPlayers = static_cast<uint8_t>(numPlayers < 2 ? 2 : numPlayers > MAX_SEATS ? MAX_SEATS : numPlayers);
+        view.seat = static_cast<uint8_t>(seat < view.numPlayers ? seat : view.numPlayers - 1);
+
+        int unseen = bitboard::popcount(bitboard::FULL_DECK & ~table & ~hand);
+        int others = view.numPlayers - 1;
+        for (int player = 0, other = 0; player < view.numPlayers; player++) {
+            if (player == view.seat) {
+                view.handCounts[player] = static_cast<uint8_t>(bitboard::popcount(hand));
+            } else {
+                view.handCounts[player] = static_cast<uint8_t>(unseen / others + (other < unseen % others));
+                other++;
+            }
+        }
+        return view;
+    }
+};
+
+} // namespace sevens
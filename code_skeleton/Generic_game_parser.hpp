@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Generic_card_parser.hpp"
+#include "Bitboard.hpp"
 #include <unordered_map>
 #include <string>
 #include <cstdint> // Add this line
@@ -8,22 +9,36 @@ namespace sevens {
 
 /**
  * Extends Generic_card_parser to handle game-state data for Sevens:
- *   - table_layout[suit][rank] = true if that rank is on the table.
+ *   - table_bits has bit cardBit(suit, rank) set if that rank is on the table.
+ *     This bitboard is the source of truth for the game state.
+ *   - get_table_layout() returns a map, [suit][rank] = true if that rank
+ *     is on the table, built from table_bits for callers of the legacy
+ *     map interface. Callers that keep a map between calls can update it
+ *     incrementally with bitboard::syncTableLayout instead.
  * Subclasses must override read_game(...) to set up the initial table.
  */
 class Generic_game_parser : public Generic_card_parser {
 public:
     virtual void read_game(const std::string& filename) = 0;
 
-    // Provide read-only access to the table layout
-    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>&
+    // Provide read-only access to the table bitboard
+    CardMask get_table_bits() const {
+        return this->table_bits;
+    }
+
+    // Build the table layout from the bitboard into a map owned by the
+    // caller (the parser keeps no copy, so concurrent readers are safe)
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>
     get_table_layout() const {
-        return this->table_layout;
+        std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> layout;
+        CardMask mirrored = 0;
+        bitboard::syncTableLayout(table_bits, mirrored, layout);
+        return layout;
     }
 
 protected:
-    // For each suit -> rank -> bool (true if on table)
-    std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> table_layout;
+    // One bit per card on the table (see Bitboard.hpp)
+    CardMask table_bits = 0;
 };
 
 } // namespace sevens
@@ -1,5 +1,6 @@
 // GreedyStrategy.cpp
 #include "GreedyStrategy.hpp"
+#include "LegalMoves.hpp"
 #include <algorithm>
 #include <iostream>
 
@@ -19,46 +20,32 @@ int GreedyStrategy::selectCardToPlay(
     }
     
     // Find the first playable card in the hand
-    for (int i = 0; i < static_cast<int>(hand.size()); i++) {
-        const Card& card = hand[i];
-        int suit = card.suit;
-        int rank = card.rank;
-        
-        // Special case: 7s can be played only if not already on the table
-        if (rank == 7) {
-            // Check if this 7 is already on the table
-            if (tableLayout.count(suit) > 0 && 
-                tableLayout.at(suit).count(rank) > 0 && 
-                tableLayout.at(suit).at(rank)) {
-                // This 7 is already on the table, cannot play it
-                continue;
-            } else {
-                // This 7 is not on the table, can play it
-                return i;
-            }
-        }
-        
-        // Check if rank+1 is on the table
-        bool higher = (rank < 13 && 
-                      tableLayout.count(suit) > 0 && 
-                      tableLayout.at(suit).count(rank+1) > 0 && 
-                      tableLayout.at(suit).at(rank+1));
-                      
-        // Check if rank-1 is on the table
-        bool lower = (rank > 1 && 
-                     tableLayout.count(suit) > 0 && 
-                     tableLayout.at(suit).count(rank-1) > 0 && 
-                     tableLayout.at(suit).at(rank-1));
-        
-        if (higher || lower) {
-            return i;
-        }
+    moves::PlayableList playable =
+        moves::playableIndices(hand, bitboard::fromTableLayout(tableLayout));
+    
+    if (!playable.empty()) {
+        return playable[0];
     }
     
     // No playable card found
     return -1;
 }
 
+int GreedyStrategy::selectCard(GameView view) {
+    // Play the first playable card of the hand in deal order, as the
+    // version 1 path does; without a deal order, the lowest one
+    CardMask playable = view.legalMoves();
+    if (!playable) {
+        return -1;
+    }
+    for (size_t i = 0; i < dealCount; i++) {
+        if (playable >> dealOrder[i] & 1) {
+            return dealOrder[i];
+        }
+    }
+    return bitboard::lowestBit(playable);
+}
+
 void GreedyStrategy::observeMove(uint64_t /*playerID*/, const Card& /*playedCard*/) {
     // Ignored in minimal version
 }
@@ -67,6 +54,16 @@ void GreedyStrategy::observePass(uint64_t /*playerID*/) {
     // Ignored in minimal version
 }
 
+uint32_t GreedyStrategy::subscribedEvents() const {
+    // Other players' moves and passes are ignored
+    return events::NONE;
+}
+
+void GreedyStrategy::setDealOrder(const uint8_t* cards, size_t count) {
+    dealOrder = cards;
+    dealCount = count;
+}
+
 std::string GreedyStrategy::getName() const {
     return "GreedyStrategy";
 }
@@ -81,4 +78,8 @@ std::string GreedyStrategy::getName() const {
 extern "C" sevens::PlayerStrategy* createStrategy() {
     return new sevens::GreedyStrategy();
 }
+
+extern "C" sevens::PlayerStrategyV2* createStrategyV2() {
+    return new sevens::GreedyStrategy();
+}
 #endif
\ No newline at end of file
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "PlayerStrategy.hpp"
+#include "PlayerStrategyV2.hpp"
 
 namespace sevens {
 
 /**
  * A (placeholder) greedy strategy skeleton.
  */
-class GreedyStrategy : public PlayerStrategy {
+class GreedyStrategy : public PlayerStrategy, public PlayerStrategyV2, public DealOrderStrategy {
 public:
     GreedyStrategy() = default;
     ~GreedyStrategy() override = default;
@@ -19,9 +20,16 @@ public:
     void observeMove(uint64_t playerID, const Card& playedCard) override;
     void observePass(uint64_t playerID) override;
     std::string getName() const override;
+    int selectCard(GameView view) override;
+    uint32_t subscribedEvents() const override;
+    void setDealOrder(const uint8_t* cards, size_t count) override;
     
 private:
     uint64_t myID;
+
+    // Deck in deal order, from the engine (null until the first deal)
+    const uint8_t* dealOrder = nullptr;
+    size_t dealCount = 0;
 };
 
 } // namespace sevens
@@ -0,0 +1,289 @@
+// ISMCTSStrategy.cpp
+#include "ISMCTSStrategy.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+namespace sevens {
+
+namespace {
+
+uint64_t readSetting(const char* name, uint64_t fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+// Iterations between two looks at the clock
+const int CLOCK_INTERVAL = 32;
+
+} // namespace
+
+ISMCTSConfig ISMCTSConfig::fromEnvironment() {
+    ISMCTSConfig config;
+    config.iterations = static_cast<int>(readSetting("ISMCTS_ITERATIONS", config.iterations));
+    config.timeBudgetMs = static_cast<double>(readSetting("ISMCTS_TIME_MS", 0));
+    config.arenaNodes = static_cast<uint32_t>(readSetting("ISMCTS_NODES", config.arenaNodes));
+    return config;
+}
+
+ISMCTSStrategy::ISMCTSStrategy() : ISMCTSStrategy(ISMCTSConfig::fromEnvironment()) {}
+
+ISMCTSStrategy::ISMCTSStrategy(const ISMCTSConfig& config) : settings(config) {
+    if (settings.iterations < 1) settings.iterations = 1;
+    // Room for the root and one full block of children
+    if (settings.arenaNodes < moves::MAX_PLAYABLE + 2) settings.arenaNodes = moves::MAX_PLAYABLE + 2;
+
+    auto seed = static_cast<uint64_t>(
+        std::chrono::system_clock::now().time_since_epoch().count()
+    );
+    rng = RngStream(seed);
+    arena.resize(settings.arenaNodes);
+    path.reserve(settings.arenaNodes);
+}
+
+void ISMCTSStrategy::seedRandom(const RngStream& stream) {
+    rng = stream;
+}
+
+void ISMCTSStrategy::initialize(uint64_t playerID) {
+    myID = playerID;
+    highestSeat = std::max(highestSeat, playerID);
+}
+
+int ISMCTSStrategy::selectCardToPlay(
+    const std::vector<Card>& hand,
+    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout)
+{
+    // The version 1 interface does not say how many players there are:
+    // assume the seats seen so far
+    CardMask table = bitboard::fromTableLayout(tableLayout);
+    beliefs.syncTable(table);
+    GameView view = GameState::guessView(bitboard::fromCards(hand), table,
+                                         static_cast<int>(myID), static_cast<int>(highestSeat + 1));
+    int bit = chooseCard(view, defaultBudget());
+    if (bit < 0) {
+        return -1;
+    }
+    for (int i = 0; i < static_cast<int>(hand.size()); i++) {
+        if (bitboard::cardBit(hand[i].suit, hand[i].rank) == bit) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int ISMCTSStrategy::selectCard(GameView view) {
+    beliefs.sync(view);
+    return chooseCard(view, defaultBudget());
+}
+
+int ISMCTSStrategy::selectCardWithin(GameView view, const SearchBudget& budget) {
+    beliefs.sync(view);
+    return chooseCard(view, budget.limited() ? budget : defaultBudget());
+}
+
+SearchBudget ISMCTSStrategy::defaultBudget() const {
+    SearchBudget budget;
+    if (settings.timeBudgetMs > 0) {
+        budget = SearchBudget::within(settings.timeBudgetMs / 1000.0);
+    }
+    budget.nodes = static_cast<uint64_t>(settings.iterations);
+    return budget;
+}
+
+bool ISMCTSStrategy::expand(uint32_t index, const GameState& state, CardMask ourCards) {
+    // Every move the seat to move could make in this information set
+    CardMask cards;
+    bool canPass;
+    if (state.toMove == static_cast<int>(arena[0].mover)) {
+        cards = state.legalMoves();
+        canPass = cards == 0;
+    } else {
+        cards = moves::playableCards(state.table) & ~ourCards;
+        canPass = true;
+    }
+
+    uint32_t count = bitboard::popcount(cards) + canPass;
+    if (used + count > arena.size()) {
+        return false;
+    }
+
+    Node& node = arena[index];
+    node.firstChild = used;
+    node.numChildren = static_cast<uint8_t>(count);
+    auto add = [&](int move) {
+        arena[used++] = Node{0.0f, 0, 0, 0, 0, static_cast<uint8_t>(move), static_cast<uint8_t>(state.toMove), 0};
+    };
+    bitboard::forEachCard(cards, add);
+    if (canPass) {
+        add(PASS);
+    }
+    return true;
+}
+
+uint32_t ISMCTSStrategy::selectChild(uint32_t index, const GameState& state) {
+    const Node& node = arena[index];
+    CardMask legal = state.legalMoves();
+
+    // Count the availability of every move legal in this deal and take
+    // the first that was never tried; failing that, the best by UCB
+    uint32_t untried = 0;
+    bool haveUntried = false;
+    for (uint32_t child = node.firstChild; child < node.firstChild + node.numChildren; child++) {
+        Node& option = arena[child];
+        bool available = option.move == PASS ? legal == 0 : (legal >> option.move & 1) != 0;
+        if (!available) continue;
+        option.available++;
+        if (option.visits == 0 && !haveUntried) {
+            untried = child;
+            haveUntried = true;
+        }
+    }
+    if (haveUntried) {
+        return untried;
+    }
+
+    uint32_t best = 0;
+    double bestScore = -1.0;
+    for (uint32_t child = node.firstChild; child < node.firstChild + node.numChildren; child++) {
+        const Node& option = arena[child];
+        bool available = option.move == PASS ? legal == 0 : (legal >> option.move & 1) != 0;
+        if (!available) continue;
+        double score = option.reward / option.visits
+                     + settings.exploration * std::sqrt(std::log(double(option.available)) / option.visits);
+        if (score > bestScore) {
+            best = child;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+int ISMCTSStrategy::chooseCard(const GameView& view, const SearchBudget& budget) {
+    CardMask legal = view.legalMoves();
+    if (!legal) {
+        return -1;
+    }
+    if (bitboard::popcount(legal) == 1) {
+        return bitboard::lowestBit(legal);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const int maxIterations = budget.nodes && budget.nodes < INT_MAX ? static_cast<int>(budget.nodes) : INT_MAX;
+
+    // Rewards are scaled by the cards each seat holds now
+    const int numPlayers = view.numPlayers;
+    double scale[GameView::MAX_SEATS];
+    for (int seat = 0; seat < numPlayers; seat++) {
+        scale[seat] = 1.0 / std::max(1, int(view.handCounts[seat]));
+    }
+
+    const DealSampler sampler(view, &beliefs);
+
+    // Reset the arena to just the root; its mover marks our seat
+    arena[0] = Node{0.0f, 0, 0, 0, 0, PASS, view.seat, 0};
+    used = 1;
+    bool arenaFull = false;
+
+    int iteration = 0;
+    while (iteration < maxIterations) {
+        if (budget.timed() && iteration > 0 && iteration % CLOCK_INTERVAL == 0 && budget.expired()) {
+            break;
+        }
+        iteration++;
+
+        // Selection and expansion on one deal of the unseen cards
+        GameState state = sampler.sample(rng, &totals.deals);
+        path.clear();
+        path.push_back(0);
+        uint32_t index = 0;
+        int passes = 0;
+        bool over = false;
+        while (!over) {
+            if (arena[index].numChildren == 0 && !expand(index, state, view.hand)) {
+                arenaFull = true;
+                break;
+            }
+            uint32_t child = selectChild(index, state);
+            path.push_back(child);
+
+            int mover = state.toMove;
+            if (arena[child].move == PASS) {
+                state.pass();
+                over = ++passes == numPlayers;
+            } else {
+                state.makeMove(arena[child].move);
+                passes = 0;
+                over = state.hands[mover] == 0;
+            }
+
+            bool added = arena[child].visits == 0;
+            index = child;
+            if (added) break;
+        }
+
+        // Simulation
+        if (!over) {
+            state.playRandomly(rng);
+        }
+
+        // Backpropagation, each node for the seat that moved into it
+        double reward[GameView::MAX_SEATS];
+        for (int seat = 0; seat < numPlayers; seat++) {
+            reward[seat] = 1.0 - state.cardsLeft(seat) * scale[seat];
+        }
+        arena[0].visits++;
+        for (size_t i = 1; i < path.size(); i++) {
+            Node& node = arena[path[i]];
+            node.visits++;
+            node.reward += static_cast<float>(reward[node.mover]);
+        }
+    }
+
+    // The root card tried most often
+    const Node& root = arena[0];
+    int bestMove = bitboard::lowestBit(legal);
+    uint32_t bestVisits = 0;
+    for (uint32_t child = root.firstChild; child < root.firstChild + root.numChildren; child++) {
+        if (arena[child].visits > bestVisits) {
+            bestMove = arena[child].move;
+            bestVisits = arena[child].visits;
+        }
+    }
+
+    totals.decisions++;
+    totals.iterations += iteration;
+    totals.nodes += used;
+    totals.peakNodes = std::max(totals.peakNodes, used);
+    totals.arenaFull += arenaFull;
+    totals.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return bestMove;
+}
+
+void ISMCTSStrategy::observeMove(uint64_t playerID, const Card& playedCard) {
+    highestSeat = std::max(highestSeat, playerID);
+    beliefs.observeMove(playerID, playedCard);
+}
+
+void ISMCTSStrategy::observePass(uint64_t playerID) {
+    highestSeat = std::max(highestSeat, playerID);
+    beliefs.observePass(playerID);
+}
+
+std::string ISMCTSStrategy::getName() const {
+    return "ISMCTSStrategy";
+}
+
+} // namespace sevens
+
+#ifdef BUILD_SHARED_LIB
+extern "C" sevens::PlayerStrategy* createStrategy() {
+    return new sevens::ISMCTSStrategy();
+}
+
+extern "C" sevens::PlayerStrategyV2* createStrategyV2() {
+    return new sevens::ISMCTSStrategy();
+}
+#endif
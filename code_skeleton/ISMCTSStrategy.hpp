@@ -0,0 +1,137 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include "PlayerStrategyV2.hpp"
+#include "GameState.hpp"
+#include "BeliefTracker.hpp"
+#include "DealSampler.hpp"
+#include "LegalMoves.hpp"
+#include "RngStream.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+// Settings of ISMCTSStrategy
+struct ISMCTSConfig {
+    int iterations = 2000;          // search iterations per decision
+    double timeBudgetMs = 0;        // stop searching after this long (0 = no limit)
+    uint32_t arenaNodes = 1 << 17;  // tree nodes available to a decision
+    double exploration = 0.7;       // UCB exploration constant
+
+    // Read from ISMCTS_ITERATIONS, ISMCTS_TIME_MS and ISMCTS_NODES (unset
+    // ones keep the defaults)
+    static ISMCTSConfig fromEnvironment();
+};
+
+// Work done by an ISMCTSStrategy since it was created
+struct ISMCTSStats {
+    uint64_t decisions = 0;   // decisions with more than one legal move
+    uint64_t iterations = 0;
+    uint64_t nodes = 0;       // tree nodes allocated
+    uint32_t peakNodes = 0;   // most nodes used by one decision
+    uint64_t arenaFull = 0;   // decisions that ran out of nodes
+    double seconds = 0.0;
+    DealStats deals;
+};
+
+/**
+ * Single-observer Information Set Monte Carlo Tree Search (SO-ISMCTS).
+ *
+ * One tree is grown over our information sets: a node stands for the
+ * sequence of cards played (and passes) since the decision, not for a
+ * full deal. Every iteration deals the unseen cards at random, as the
+ * passes seen allow (DealSampler), and walks down the tree using only the moves that
+ * are legal in that deal, choosing among them by UCB with availability
+ * counts. It adds one node and finishes the round with random playouts.
+ * Each node keeps the reward of the seat that made its move, which is 1
+ * minus the share of that seat's cards it is left with at the end of the
+ * round. The most visited card at the root is played.
+ *
+ * Nodes come from an arena that is allocated once and reset for every
+ * decision. When a node is expanded, all its children are allocated as
+ * one contiguous block. That block holds every move its seat could
+ * possibly make: our legal cards, or for another seat the cards it might
+ * hold that fit on the table, plus a pass. So at most nine nodes are
+ * allocated at a time, and a node's children are never moved or grown.
+ * When the arena is full, the tree stops growing and the remaining
+ * iterations only play out from its leaves.
+ */
+class ISMCTSStrategy : public PlayerStrategy, public PlayerStrategyV2, public SeededStrategy,
+                       public AnytimeStrategy {
+public:
+    ISMCTSStrategy();
+    explicit ISMCTSStrategy(const ISMCTSConfig& config);
+    ~ISMCTSStrategy() override = default;
+
+    // PlayerStrategy interface
+    void initialize(uint64_t playerID) override;
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override;
+    void observeMove(uint64_t playerID, const Card& playedCard) override;
+    void observePass(uint64_t playerID) override;
+    std::string getName() const override;
+
+    // PlayerStrategyV2 interface
+    int selectCard(GameView view) override;
+
+    // SeededStrategy interface
+    void seedRandom(const RngStream& stream) override;
+
+    // AnytimeStrategy interface (one work unit = one iteration)
+    int selectCardWithin(GameView view, const SearchBudget& budget) override;
+
+    const ISMCTSConfig& config() const { return settings; }
+    const ISMCTSStats& stats() const { return totals; }
+
+    // Bytes taken by the node arena
+    uint64_t arenaBytes() const { return arena.size() * sizeof(Node); }
+
+private:
+    static constexpr uint8_t PASS = 0xFF;          // move of a pass node
+
+    struct Node {
+        float reward;          // total reward of `mover` over the visits
+        uint32_t visits;
+        uint32_t available;    // iterations in which this move was legal
+        uint32_t firstChild;   // children are arena[firstChild, firstChild + numChildren)
+        uint8_t numChildren;
+        uint8_t move;          // card bit, or PASS
+        uint8_t mover;         // seat making the move
+        uint8_t padding;
+    };
+    static_assert(sizeof(Node) == 20, "Node should stay small");
+
+    uint64_t myID = 0;
+    RngStream rng;
+    ISMCTSConfig settings;
+    ISMCTSStats totals;
+    std::vector<Node> arena;
+    uint32_t used = 0;
+    std::vector<uint32_t> path;   // nodes visited by the current iteration
+
+    // Highest seat seen playing or passing, for the version 1 interface
+    uint64_t highestSeat = 0;
+
+    // Cards ruled out for the other seats by their passes; deals are
+    // drawn to agree with it
+    BeliefTracker beliefs;
+
+    // The budget given by the settings
+    SearchBudget defaultBudget() const;
+
+    // Card bit to play for view.seat, or -1 to pass
+    int chooseCard(const GameView& view, const SearchBudget& budget);
+
+    // Allocate the children of `index` for the position `state` is in;
+    // false when the arena has no room left
+    bool expand(uint32_t index, const GameState& state, CardMask ourCards);
+
+    // Child of `index` to follow in `state`, by UCB among the moves legal there
+    uint32_t selectChild(uint32_t index, const GameState& state);
+};
+
+} // namespace sevens
@@ -0,0 +1,391 @@
+// League.cpp
+#include "League.hpp"
+#include "RngStream.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace sevens {
+
+namespace {
+
+const int MAX_FIT_ITERATIONS = 10000;
+const double FIT_TOLERANCE = 1e-10;
+const double Z_95 = 1.959964;
+
+// Elo points per unit of natural-log strength
+const double ELO_PER_NAT = 400.0 / std::log(10.0);
+
+// Inverse of the n x n matrix `m` (row-major) by Gauss-Jordan elimination
+// with partial pivoting; `m` must be invertible
+std::vector<double> invert(std::vector<double> m, int n) {
+    std::vector<double> inverse(n * n, 0.0);
+    for (int i = 0; i < n; i++) {
+        inverse[i * n + i] = 1.0;
+    }
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < n; row++) {
+            if (std::fabs(m[row * n + col]) > std::fabs(m[pivot * n + col])) {
+                pivot = row;
+            }
+        }
+        for (int k = 0; k < n; k++) {
+            std::swap(m[col * n + k], m[pivot * n + k]);
+            std::swap(inverse[col * n + k], inverse[pivot * n + k]);
+        }
+        double scale = 1.0 / m[col * n + col];
+        for (int k = 0; k < n; k++) {
+            m[col * n + k] *= scale;
+            inverse[col * n + k] *= scale;
+        }
+        for (int row = 0; row < n; row++) {
+            if (row == col) continue;
+            double factor = m[row * n + col];
+            if (factor == 0.0) continue;
+            for (int k = 0; k < n; k++) {
+                m[row * n + k] -= factor * m[col * n + k];
+                inverse[row * n + k] -= factor * inverse[col * n + k];
+            }
+        }
+    }
+    return inverse;
+}
+
+// FNV-1a, stable across platforms (table seeds must not change)
+uint64_t hashText(const std::string& text) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+League::League(const MyGameMapper& prototypeEngine, std::vector<std::string> specs,
+               std::vector<StrategyFactory> strategyFactories, const LeagueConfig& config)
+    : prototype(prototypeEngine), pool(std::move(specs)), factories(std::move(strategyFactories)),
+      settings(config) {
+    if (settings.playerCounts.empty()) {
+        settings.playerCounts = {2, 3, 4};
+    }
+    for (const StrategyFactory& factory : factories) {
+        names.push_back(factory()->getName());
+    }
+}
+
+bool League::loadState(std::string& error) {
+    if (settings.statePath.empty()) {
+        return true;
+    }
+    std::ifstream in(settings.statePath);
+    if (!in) {
+        return true;   // first run
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') continue;
+
+        // table <games> <seats> <spec per seat> <wins per seat pair> <ties per seat pair>
+        std::istringstream fields(line);
+        std::string kind;
+        Table table;
+        size_t numSeats = 0;
+        fields >> kind >> table.games >> numSeats;
+        bool valid = kind == "table" && numSeats >= 2 && numSeats <= GameView::MAX_SEATS;
+        bool inPool = true;
+        for (size_t seat = 0; valid && seat < numSeats; seat++) {
+            std::string spec;
+            fields >> spec;
+            auto it = std::find(pool.begin(), pool.end(), spec);
+            inPool = inPool && it != pool.end();
+            table.seats.push_back(static_cast<int>(it - pool.begin()));
+        }
+        table.pairWins.resize(numSeats * numSeats);
+        table.pairTies.resize(numSeats * numSeats);
+        for (size_t i = 0; valid && i < numSeats * numSeats; i++) {
+            fields >> table.pairWins[i];
+        }
+        for (size_t i = 0; valid && i < numSeats * numSeats; i++) {
+            fields >> table.pairTies[i];
+        }
+        if (!valid || fields.fail()) {
+            error = settings.statePath + ":" + std::to_string(lineNumber) + ": not a table result";
+            return false;
+        }
+        if (inPool && !isPlayed(table.seats)) {
+            played.push_back(table);
+        }
+    }
+    return true;
+}
+
+// Every seat order of every set of distinct strategies, by table size
+std::vector<std::vector<int>> League::schedule() const {
+    std::vector<std::vector<int>> tables;
+    const int poolSize = static_cast<int>(pool.size());
+    for (int size : settings.playerCounts) {
+        if (size < 2 || size > poolSize || size > GameView::MAX_SEATS) continue;
+
+        // Sets in lexicographic order, then their permutations
+        std::vector<int> chosen(size);
+        for (int i = 0; i < size; i++) {
+            chosen[i] = i;
+        }
+        for (;;) {
+            std::vector<int> seats = chosen;
+            do {
+                tables.push_back(seats);
+            } while (std::next_permutation(seats.begin(), seats.end()));
+
+            int i = size - 1;
+            while (i >= 0 && chosen[i] == poolSize - size + i) {
+                i--;
+            }
+            if (i < 0) break;
+            chosen[i]++;
+            for (int j = i + 1; j < size; j++) {
+                chosen[j] = chosen[j - 1] + 1;
+            }
+        }
+    }
+    return tables;
+}
+
+bool League::isPlayed(const std::vector<int>& seats) const {
+    for (const Table& table : played) {
+        if (table.seats == seats) return true;
+    }
+    return false;
+}
+
+// Derived from the specs in seat order, so a table keeps its games when
+// the pool changes around it
+uint64_t League::tableSeed(const std::vector<int>& seats) const {
+    std::string key;
+    for (int index : seats) {
+        key += pool[index];
+        key += '\n';
+    }
+    RngStream stream = RngStream(settings.seed).derive(hashText(key));
+    return stream();
+}
+
+League::Table League::playTable(const std::vector<int>& seats) const {
+    std::vector<StrategyFactory> seatFactories;
+    for (int index : seats) {
+        seatFactories.push_back(factories[index]);
+    }
+    GameSimulator simulator(prototype, seatFactories);
+    SimulationStats stats = simulator.run(settings.gamesPerTable, tableSeed(seats), 1);
+
+    Table table;
+    table.seats = seats;
+    table.games = stats.games;
+    table.pairWins = stats.pairWins;
+    table.pairTies = stats.pairTies;
+    return table;
+}
+
+void League::appendState(const Table& table) const {
+    if (settings.statePath.empty()) {
+        return;
+    }
+    std::ofstream out(settings.statePath, std::ios::app);
+    out << "table " << table.games << " " << table.seats.size();
+    for (int index : table.seats) {
+        out << " " << pool[index];
+    }
+    for (uint64_t wins : table.pairWins) {
+        out << " " << wins;
+    }
+    for (uint64_t ties : table.pairTies) {
+        out << " " << ties;
+    }
+    out << "\n";
+}
+
+void League::run(std::ostream& progress) {
+    std::vector<std::vector<int>> pending;
+    std::vector<std::vector<int>> all = schedule();
+    for (const std::vector<int>& seats : all) {
+        if (!isPlayed(seats)) {
+            pending.push_back(seats);
+        }
+    }
+    progress << all.size() << " tables of " << settings.gamesPerTable << " games, "
+             << all.size() - pending.size() << " already played"
+             << " (each result: the share of head-to-head comparisons won by each seat)\n";
+    if (pending.empty()) {
+        return;
+    }
+
+    unsigned numThreads = settings.threads ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+    numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, pending.size()));
+
+    std::atomic<size_t> nextTable{0};
+    std::mutex resultsMutex;
+    size_t finished = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    auto work = [&] {
+        for (;;) {
+            size_t index = nextTable.fetch_add(1, std::memory_order_relaxed);
+            if (index >= pending.size()) break;
+            Table table = playTable(pending[index]);
+
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            played.push_back(table);
+            appendState(table);
+            finished++;
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            progress << "[" << finished << "/" << pending.size() << ", " << std::fixed << std::setprecision(1)
+                     << seconds << "s]";
+            const size_t numSeats = table.seats.size();
+            for (size_t seat = 0; seat < numSeats; seat++) {
+                uint64_t wins = 0;
+                for (size_t other = 0; other < numSeats; other++) {
+                    wins += table.pairWins[seat * numSeats + other];
+                }
+                double share = table.games ? 100.0 * wins / (table.games * (numSeats - 1)) : 0.0;
+                progress << (seat ? ", " : " ") << names[table.seats[seat]] << " " << share << "%";
+            }
+            progress << "\n" << std::defaultfloat << std::flush;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < numThreads; t++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+std::vector<Rating> League::ratings() const {
+    const int n = static_cast<int>(pool.size());
+
+    // Head-to-head totals between strategies, starting with one virtual
+    // tie per pair
+    std::vector<double> score(n * n, 0.0), count(n * n, 0.0);
+    for (int a = 0; a < n; a++) {
+        for (int b = 0; b < n; b++) {
+            if (a == b) continue;
+            score[a * n + b] = 0.5;
+            count[a * n + b] = 1.0;
+        }
+    }
+    std::vector<uint64_t> games(n, 0);
+    std::vector<double> realScore(n, 0.0), realCount(n, 0.0);
+    for (const Table& table : played) {
+        const size_t numSeats = table.seats.size();
+        for (size_t i = 0; i < numSeats; i++) {
+            int a = table.seats[i];
+            games[a] += table.games;
+            for (size_t j = 0; j < numSeats; j++) {
+                if (i == j) continue;
+                int b = table.seats[j];
+                double points = table.pairWins[i * numSeats + j] + 0.5 * table.pairTies[i * numSeats + j];
+                score[a * n + b] += points;
+                count[a * n + b] += static_cast<double>(table.games);
+                realScore[a] += points;
+                realCount[a] += static_cast<double>(table.games);
+            }
+        }
+    }
+
+    // Minorize-maximize updates of the strengths, kept at geometric mean 1
+    std::vector<double> strength(n, 1.0);
+    for (int iteration = 0; iteration < MAX_FIT_ITERATIONS; iteration++) {
+        std::vector<double> next(n);
+        double logSum = 0.0;
+        for (int a = 0; a < n; a++) {
+            double won = 0.0, denominator = 0.0;
+            for (int b = 0; b < n; b++) {
+                if (a == b) continue;
+                won += score[a * n + b];
+                denominator += count[a * n + b] / (strength[a] + strength[b]);
+            }
+            next[a] = denominator > 0.0 ? won / denominator : 1.0;
+            logSum += std::log(next[a]);
+        }
+        double norm = std::exp(logSum / n);
+        double change = 0.0;
+        for (int a = 0; a < n; a++) {
+            next[a] /= norm;
+            change = std::max(change, std::fabs(next[a] / strength[a] - 1.0));
+        }
+        strength.swap(next);
+        if (change < FIT_TOLERANCE) break;
+    }
+
+    // Fisher information of the log-strengths. It is singular along the
+    // all-ones direction (only differences are identified), so the
+    // covariance of the mean-zero solution is inverse(I + J/n) - J/n.
+    std::vector<double> information(n * n, 0.0);
+    for (int a = 0; a < n; a++) {
+        for (int b = 0; b < n; b++) {
+            if (a == b) continue;
+            double p = strength[a] / (strength[a] + strength[b]);
+            double term = count[a * n + b] * p * (1.0 - p);
+            information[a * n + b] -= term;
+            information[a * n + a] += term;
+        }
+    }
+    for (double& entry : information) {
+        entry += 1.0 / n;
+    }
+    std::vector<double> covariance = invert(information, n);
+
+    std::vector<Rating> result(n);
+    for (int a = 0; a < n; a++) {
+        Rating& rating = result[a];
+        rating.spec = pool[a];
+        rating.name = names[a];
+        rating.elo = std::log(strength[a]) * ELO_PER_NAT;
+        double variance = std::max(0.0, covariance[a * n + a] - 1.0 / n);
+        rating.margin = Z_95 * std::sqrt(variance) * ELO_PER_NAT;
+        rating.games = games[a];
+        rating.scoreRate = realCount[a] > 0.0 ? realScore[a] / realCount[a] : 0.0;
+    }
+    std::stable_sort(result.begin(), result.end(), [](const Rating& x, const Rating& y) {
+        return x.elo > y.elo;
+    });
+    return result;
+}
+
+void League::printRatings(const std::vector<Rating>& ratings, std::ostream& os) {
+    os << "\n=================================\n";
+    os << "LEAGUE RATINGS (Bradley-Terry, Elo scale)\n";
+    os << "=================================\n";
+    os << "Rank      Elo    95%     Games   Score  Strategy\n";
+    int rank = 1;
+    for (const Rating& rating : ratings) {
+        os << std::setw(4) << rank++ << "  "
+           << std::showpos << std::fixed << std::setprecision(1) << std::setw(7) << rating.elo << std::noshowpos
+           << "  +-" << std::setw(5) << rating.margin
+           << std::setw(10) << rating.games
+           << std::setw(7) << 100.0 * rating.scoreRate << "%  "
+           << rating.name;
+        if (rating.spec != rating.name) {
+            os << " (" << rating.spec << ")";
+        }
+        os << "\n";
+    }
+    os << std::defaultfloat;
+}
+
+} // namespace sevens
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "GameSimulator.hpp"
+#include "MyGameMapper.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+// Settings of League
+struct LeagueConfig {
+    uint64_t gamesPerTable = 100;
+    uint64_t seed = 0;
+    unsigned threads = 0;              // tables played at once (0 = all cores)
+    std::vector<int> playerCounts;     // table sizes (empty = 2, 3 and 4)
+    std::string statePath;             // results of earlier runs (empty = none)
+};
+
+// One strategy's Bradley-Terry rating, on the Elo scale
+struct Rating {
+    std::string spec;
+    std::string name;
+    double elo = 0.0;           // the pool averages 0
+    double margin = 0.0;        // half-width of the 95% interval
+    uint64_t games = 0;         // games played, over all tables
+    double scoreRate = 0.0;     // share of head-to-head comparisons won (ties count half)
+};
+
+/**
+ * Round-robin league over a pool of strategies.
+ *
+ * Every table composition is scheduled once. For each player count, that
+ * is every set of distinct strategies of that size in every seat order.
+ * A table plays `gamesPerTable` games on a seed derived from its
+ * composition, so a table always plays the same games. Tables run on a
+ * single thread each, several at a time, and the result of each is
+ * reported as it finishes.
+ *
+ * Every game is scored as head-to-head comparisons between each pair of
+ * seats at the table: fewer cards left wins, equal is a tie. Ratings are
+ * the Bradley-Terry model fitted to all comparisons (minorize-maximize
+ * iterations), with one virtual tie between every pair of strategies
+ * so that a strategy that never wins still gets a finite rating. The
+ * intervals come from the inverse of the Fisher information. Comparisons
+ * taken from the same game are not independent, so with more than two
+ * players the intervals are somewhat too narrow.
+ *
+ * With a state file, the result of every finished table is appended to
+ * it, and tables already in it are not played again. Adding a strategy
+ * to the pool then plays only the tables that include it and refits the
+ * ratings from everything recorded. Tables of strategies no longer in
+ * the pool are kept in the file but ignored.
+ */
+class League {
+public:
+    League(const MyGameMapper& prototypeEngine, std::vector<std::string> specs,
+           std::vector<StrategyFactory> factories, const LeagueConfig& config);
+
+    // Read the state file, if any; false (with `error` set) if it cannot
+    // be parsed
+    bool loadState(std::string& error);
+
+    // Play the tables not in the state yet, streaming results to `progress`
+    void run(std::ostream& progress);
+
+    // Fit the ratings to every table played or loaded, best first
+    std::vector<Rating> ratings() const;
+
+    static void printRatings(const std::vector<Rating>& ratings, std::ostream& os);
+
+private:
+    // Result of one table: the pool index in each seat and the seat
+    // versus seat comparisons
+    struct Table {
+        std::vector<int> seats;
+        uint64_t games = 0;
+        std::vector<uint64_t> pairWins;   // [a * seats + b], as in SimulationStats
+        std::vector<uint64_t> pairTies;
+    };
+
+    MyGameMapper prototype;
+    std::vector<std::string> pool;
+    std::vector<StrategyFactory> factories;
+    std::vector<std::string> names;
+    LeagueConfig settings;
+    std::vector<Table> played;
+
+    std::vector<std::vector<int>> schedule() const;
+    bool isPlayed(const std::vector<int>& seats) const;
+    uint64_t tableSeed(const std::vector<int>& seats) const;
+    Table playTable(const std::vector<int>& seats) const;
+    void appendState(const Table& table) const;
+};
+
+} // namespace sevens
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include <array>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Shared legal-move generator for Sevens.
+ *
+ * A card can be placed when it is a 7 that is not yet on the table, or
+ * when the card of rank-1 or rank+1 of the same suit is on the table.
+ * On a bitboard this is a couple of shifts: every suit lane is padded
+ * with clear guard bits, so shifting the table by one rank never mixes
+ * suits.
+ */
+namespace moves {
+
+// At most two cards per suit can be legal (one at each end of the row)
+constexpr int MAX_PLAYABLE = 8;
+
+// Every card that may legally be placed on this table
+inline CardMask playableCards(CardMask table) {
+    CardMask neighbours = (table << 1) | (table >> 1);
+    return (neighbours | bitboard::SEVENS) & ~table & bitboard::FULL_DECK;
+}
+
+// The cards of a hand that may legally be played on this table
+inline CardMask legalMoves(CardMask hand, CardMask table) {
+    return hand & playableCards(table);
+}
+
+inline bool isLegalMove(const Card& card, CardMask table) {
+    return (playableCards(table) & bitboard::cardMask(card)) != 0;
+}
+
+/**
+ * Fixed-capacity list of playable hand positions (or card bits).
+ */
+struct PlayableList {
+    std::array<int, MAX_PLAYABLE + 1> items;
+    int count = 0;
+
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+    int operator[](int i) const { return items[i]; }
+};
+
+// Positions in a legacy vector hand whose card is legal on this table
+inline PlayableList playableIndices(const std::vector<Card>& hand, CardMask table) {
+    PlayableList list;
+    CardMask playable = playableCards(table);
+
+    for (int i = 0; i < static_cast<int>(hand.size()); i++) {
+        // Always write, only advance when legal; the extra slot absorbs
+        // the write once the list is full (malformed decks with duplicates)
+        list.items[list.count] = i;
+        int legal = static_cast<int>((playable >> bitboard::cardBit(hand[i].suit, hand[i].rank)) & 1);
+        list.count += legal & (list.count < MAX_PLAYABLE);
+    }
+
+    return list;
+}
+
+// Card bits of a mask as a list (the mask must hold at most MAX_PLAYABLE cards)
+inline PlayableList toList(CardMask cards) {
+    PlayableList list;
+    bitboard::forEachCard(cards, [&](int bit) {
+        if (list.count < MAX_PLAYABLE) {
+            list.items[list.count++] = bit;
+        }
+    });
+    return list;
+}
+
+} // namespace moves
+
+} // namespace sevens
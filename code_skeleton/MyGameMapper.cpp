@@ -1,5 +1,8 @@
 #include "MyGameMapper.hpp"
 #include "RandomStrategy.hpp" 
+#include "LegalMoves.hpp"
+#include "StrategyAdapter.hpp"
+#include "AllocationCounter.hpp"
 #include <algorithm>
 #include <random>
 #include <chrono>
@@ -13,15 +16,14 @@ namespace sevens {
 
 MyGameMapper::MyGameMapper() {
     // Seed the random number generator
-    auto seed = static_cast<unsigned long>(
+    auto seed = static_cast<uint64_t>(
         std::chrono::system_clock::now().time_since_epoch().count()
     );
-    rng.seed(seed);
+    setSeed(seed);
     
     // Initialize statistics
     total_rounds = 0;
-    player_total_cards.clear();
-    player_rounds_won.clear();
+    steady_state_allocations = 0;
 }
 
 void MyGameMapper::read_cards(const std::string& filename) {
@@ -77,6 +79,9 @@ void MyGameMapper::read_cards(const std::string& filename) {
         id++;
     }
     
+    // The deck is rebuilt from the new cards at the next deal
+    deck_template.clear();
+    
     std::cout << "Parsed " << cards_hashmap.size() << " cards from " << filename << std::endl;
 }
 
@@ -86,59 +91,173 @@ void MyGameMapper::read_game(const std::string& /*filename*/) {
 }
 
 void MyGameMapper::resetTableLayout() {
-    // Initialize the table layout for all suits
-    for (int suit = 0; suit < 4; suit++) {
-        for (int rank = 1; rank <= 13; rank++) {
-            table_layout[suit][rank] = false;
-        }
-    }
-    
     // The game starts with the 7 of Diamonds on the table
-    table_layout[1][7] = true; // 1 = Diamonds, 7 = Seven
+    table_bits = bitboard::cardMask(1, 7); // 1 = Diamonds, 7 = Seven
 }
 
 bool MyGameMapper::hasRegisteredStrategies() const {
     return !player_strategies.empty();
 }
 
+void MyGameMapper::setSeed(uint64_t seed) {
+    setRandomStream(RngStream(seed));
+}
+
+void MyGameMapper::setRandomStream(const RngStream& stream) {
+    rng = stream;
+}
+
+// Give every strategy that wants one its own stream for this game
+void MyGameMapper::seedStrategies() {
+    for (uint64_t seat = 0; seat < player_strategies.size(); seat++) {
+        if (auto* seeded = dynamic_cast<SeededStrategy*>(player_strategies[seat].get())) {
+            seeded->seedRandom(rng.derive(streams::SEAT, seat));
+        }
+    }
+}
+
+uint64_t MyGameMapper::getTotalRounds() const {
+    return total_rounds;
+}
+
+uint64_t MyGameMapper::getTotalCards(uint64_t playerID) const {
+    return playerID < player_total_cards.size() ? player_total_cards[playerID] : 0;
+}
+
+uint64_t MyGameMapper::getRoundsWon(uint64_t playerID) const {
+    return playerID < player_rounds_won.size() ? player_rounds_won[playerID] : 0;
+}
+
+uint64_t MyGameMapper::getSteadyStateAllocations() const {
+    return steady_state_allocations;
+}
+
 void MyGameMapper::registerStrategy(uint64_t playerID, std::shared_ptr<PlayerStrategy> strategy) {
+    registerStrategyV2(playerID, asStrategyV2(strategy));
+}
+
+void MyGameMapper::registerStrategyV2(uint64_t playerID, std::shared_ptr<PlayerStrategyV2> strategy) {
+    // Seats are dense: player IDs index every per-player array
+    if (playerID >= player_strategies.size()) {
+        player_strategies.resize(playerID + 1);
+        player_hands.resize(playerID + 1, 0);
+        player_total_cards.resize(playerID + 1, 0);
+        player_rounds_won.resize(playerID + 1, 0);
+        anytime_strategies.resize(playerID + 1, nullptr);
+        deal_order_strategies.resize(playerID + 1, nullptr);
+        time_banks.resize(playerID + 1, 0.0);
+        think_seconds.resize(playerID + 1, 0.0);
+    }
+    
     player_strategies[playerID] = strategy;
+    anytime_strategies[playerID] = dynamic_cast<AnytimeStrategy*>(strategy.get());
+    deal_order_strategies[playerID] = dynamic_cast<DealOrderStrategy*>(strategy.get());
+    rebuildSubscribers();
     strategy->initialize(playerID);
-    
-    // Initialize statistics for this player
-    if (player_total_cards.find(playerID) == player_total_cards.end()) {
-        player_total_cards[playerID] = 0;
+}
+
+// Collect the strategies that asked for move/pass broadcasts
+void MyGameMapper::rebuildSubscribers() {
+    move_subscribers.clear();
+    pass_subscribers.clear();
+    for (uint64_t seat = 0; seat < player_strategies.size(); seat++) {
+        PlayerStrategyV2* strategy = player_strategies[seat].get();
+        if (!strategy) continue;
+        
+        uint32_t subscribed = strategy->subscribedEvents();
+        if (subscribed & events::MOVES) {
+            move_subscribers.push_back({seat, strategy});
+        }
+        if (subscribed & events::PASSES) {
+            pass_subscribers.push_back({seat, strategy});
+        }
     }
-    if (player_rounds_won.find(playerID) == player_rounds_won.end()) {
-        player_rounds_won[playerID] = 0;
+}
+
+// Inform the other subscribed strategies of a pass
+void MyGameMapper::broadcastPass(uint64_t playerID) {
+    for (const auto& subscriber : pass_subscribers) {
+        if (subscriber.first != playerID) {
+            subscriber.second->observePass(playerID);
+        }
+    }
+}
+
+// Inform the other subscribed strategies of a card played
+void MyGameMapper::broadcastMove(uint64_t playerID, const Card& card) {
+    for (const auto& subscriber : move_subscribers) {
+        if (subscriber.first != playerID) {
+            subscriber.second->observeMove(playerID, card);
+        }
     }
 }
 
 // Helper function to check if a card is playable
 bool MyGameMapper::isPlayable(const Card& card) const {
-    int suit = card.suit;
-    int rank = card.rank;
-    
-    // Special case: 7s can be played only if not already on the table
-    if (rank == 7) {
-        return !(table_layout.count(suit) > 0 && 
-                table_layout.at(suit).count(rank) > 0 && 
-                table_layout.at(suit).at(rank));
+    return moves::isLegalMove(card, table_bits);
+}
+
+// Snapshot of the round handed to a strategy at its turn
+GameView MyGameMapper::makeView(uint64_t playerID) {
+    GameView view{};
+    view.hand = player_hands[playerID];
+    view.table = table_bits;
+    view.played = table_bits & ~bitboard::cardMask(1, 7);
+    view.turn = static_cast<uint16_t>(round_turn);
+    view.seat = static_cast<uint8_t>(playerID);
+    view.numPlayers = static_cast<uint8_t>(player_strategies.size());
+    view.passedSinceLastPlay = passed_since_play;
+    
+    uint64_t seats = std::min<uint64_t>(player_hands.size(), GameView::MAX_SEATS);
+    for (uint64_t seat = 0; seat < seats; seat++) {
+        view.handCounts[seat] = static_cast<uint8_t>(bitboard::popcount(player_hands[seat]));
+        view.passCounts[seat] = round_pass_counts[seat];
     }
     
-    // Check if rank+1 is on the table
-    bool higher = (rank < 13 && 
-                  table_layout.count(suit) > 0 && 
-                  table_layout.at(suit).count(rank+1) > 0 && 
-                  table_layout.at(suit).at(rank+1));
-                  
-    // Check if rank-1 is on the table
-    bool lower = (rank > 1 && 
-                 table_layout.count(suit) > 0 && 
-                 table_layout.at(suit).count(rank-1) > 0 && 
-                 table_layout.at(suit).at(rank-1));
+    return view;
+}
+
+// A seat's choice, within its time control when it has one and can use it
+int MyGameMapper::askStrategy(uint64_t playerID) {
+    AnytimeStrategy* anytime = anytime_strategies[playerID];
+    if (!anytime || playerID >= time_controls.size() || !time_controls[playerID].active()) {
+        return player_strategies[playerID]->selectCard(makeView(playerID));
+    }
+    
+    const TimeControl& control = time_controls[playerID];
+    int64_t start = SearchBudget::now();
+    SearchBudget budget = control.budget(time_banks[playerID], bitboard::popcount(player_hands[playerID]));
+    int card_bit = anytime->selectCardWithin(makeView(playerID), budget);
     
-    return higher || lower;
+    double spent = (SearchBudget::now() - start) * 1e-9;
+    think_seconds[playerID] += spent;
+    if (control.bankSeconds > 0) {
+        time_banks[playerID] = std::max(0.0, time_banks[playerID] - spent) + control.incrementSeconds;
+    }
+    return card_bit;
+}
+
+void MyGameMapper::setTimeControl(uint64_t playerID, const TimeControl& control) {
+    if (playerID >= time_controls.size()) {
+        time_controls.resize(playerID + 1);
+    }
+    time_controls[playerID] = control;
+}
+
+double MyGameMapper::getThinkSeconds(uint64_t playerID) const {
+    return playerID < think_seconds.size() ? think_seconds[playerID] : 0.0;
+}
+
+void MyGameMapper::setRecorder(GameRecorder* recorder) {
+    game_recorder = recorder;
+}
+
+// Record a pass (or rejected move) for the GameView pass history
+void MyGameMapper::recordPass(uint64_t playerID) {
+    if (playerID < GameView::MAX_SEATS) {
+        round_pass_counts[playerID]++;
+        passed_since_play |= 1u << playerID;
+    }
 }
 
 // Main entry point - computes game progress silently
@@ -155,40 +274,70 @@ MyGameMapper::compute_and_display_game(uint64_t numPlayers) {
     return runMultipleRounds(true);
 }
 
-// Make sure we have strategies for all players
+// Make sure we have strategies for all players (and no empty seats)
 void MyGameMapper::ensureStrategies(uint64_t numPlayers) {
+    numPlayers = std::max<uint64_t>(numPlayers, player_strategies.size());
     for (uint64_t i = 0; i < numPlayers; i++) {
-        if (player_strategies.find(i) == player_strategies.end()) {
+        if (i >= player_strategies.size() || !player_strategies[i]) {
             auto randomStrat = std::make_shared<RandomStrategy>();
             registerStrategy(i, randomStrat);
         }
     }
 }
 
-// Deal cards to players at the start of a round
-void MyGameMapper::dealCards() {
-    player_hands.clear();
-   
-    // Convert cards_hashmap to a vector for shuffling, excluding the 7 of Diamonds
-    std::vector<std::pair<uint64_t, Card>> cards;
-    for (const auto& pair : cards_hashmap) {
+// Build the deck once from cards_hashmap, in card ID order
+void MyGameMapper::buildDeck() {
+    std::vector<std::pair<uint64_t, Card>> cards(cards_hashmap.begin(), cards_hashmap.end());
+    std::sort(cards.begin(), cards.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    
+    deck_template.clear();
+    for (const auto& pair : cards) {
         // Skip the 7 of Diamonds (suit=1, rank=7) because it starts on the table
         if (!(pair.second.suit == 1 && pair.second.rank == 7)) {
-            cards.push_back(pair);
+            deck_template.push_back(static_cast<uint8_t>(
+                bitboard::cardBit(pair.second.suit, pair.second.rank)));
         }
     }
-   
-    // Shuffle the cards
-    std::shuffle(cards.begin(), cards.end(), rng);
+    deck = deck_template;
+}
+
+// Deal cards to players at the start of a round
+void MyGameMapper::dealCards() {
+    if (deck_template.empty()) {
+        buildDeck();
+    }
+    
+    // Shuffle the deck in place with this round's stream; starting from the
+    // template order makes each deal depend only on the game stream and round
+    std::copy(deck_template.begin(), deck_template.end(), deck.begin());
+    RngStream dealRng = rng.derive(streams::DEAL, total_rounds);
+    dealRng.shuffle(deck.begin(), deck.end());
    
     // Determine starting player based on round number
     // This rotates who gets the first card (and potentially extra cards) each round
-    uint64_t startingPlayerID = total_rounds % player_strategies.size();
+    uint64_t numSeats = player_strategies.size();
+    if (numSeats == 0) {
+        return;
+    }
+    uint64_t startingPlayerID = total_rounds % numSeats;
+    
+    std::fill(player_hands.begin(), player_hands.end(), 0);
     
     // Deal cards to players with rotation
-    for (uint64_t i = 0; i < cards.size(); i++) {
-        uint64_t playerIndex = (startingPlayerID + i) % player_strategies.size();
-        player_hands[playerIndex].push_back(cards[i].second);
+    uint64_t playerIndex = startingPlayerID;
+    for (uint8_t bit : deck) {
+        player_hands[playerIndex] |= CardMask(1) << bit;
+        if (++playerIndex == numSeats) {
+            playerIndex = 0;
+        }
+    }
+    
+    // Each seat's hand in deal order is the deck filtered by the hand
+    for (DealOrderStrategy* strategy : deal_order_strategies) {
+        if (strategy) {
+            strategy->setDealOrder(deck.data(), deck.size());
+        }
     }
 }
 
@@ -199,18 +348,38 @@ MyGameMapper::runMultipleRounds(bool displayOutput) {
     bool gameOver = false;
     total_rounds = 0;
     
-    // Reset statistics
-    for (auto& pair : player_total_cards) {
-        pair.second = 0;
+    // Nobody would ever reach the card limit
+    if (player_strategies.empty()) {
+        return {};
+    }
+    
+    seedStrategies();
+    
+    if (game_recorder) {
+        game_recorder->beginGame(player_hands.size());
     }
-    for (auto& pair : player_rounds_won) {
-        pair.second = 0;
+    
+    // Reset statistics
+    std::fill(player_total_cards.begin(), player_total_cards.end(), 0);
+    std::fill(player_rounds_won.begin(), player_rounds_won.end(), 0);
+    
+    // Refill the time banks
+    for (uint64_t seat = 0; seat < time_banks.size(); seat++) {
+        time_banks[seat] = seat < time_controls.size() ? time_controls[seat].bankSeconds : 0.0;
+        think_seconds[seat] = 0.0;
     }
     
+    // Allocations are counted from the second round on (steady state)
+    uint64_t allocationsBefore = 0;
+    
     // Keep playing rounds until someone accumulates 50 cards
     while (!gameOver) {
         total_rounds++;
         
+        if (total_rounds == 2) {
+            allocationsBefore = allocations::count();
+        }
+        
         if (displayOutput) {
             std::cout << "\n========== ROUND " << total_rounds << " ==========\n";
         }
@@ -218,9 +387,15 @@ MyGameMapper::runMultipleRounds(bool displayOutput) {
         // Reset table layout and deal new cards
         resetTableLayout();
         dealCards();
+        if (game_recorder) {
+            game_recorder->beginRound(player_hands);
+        }
         
         // Play a single round
         uint64_t roundWinner = playRound(displayOutput);
+        if (game_recorder) {
+            game_recorder->endRound();
+        }
         
         if (roundWinner != UINT64_MAX) {
             // Update round winner stats
@@ -238,9 +413,8 @@ MyGameMapper::runMultipleRounds(bool displayOutput) {
         }
         
         // Check if any player has accumulated 50+ cards
-        for (const auto& pair : player_hands) {
-            uint64_t playerID = pair.first;
-            uint64_t cardsLeft = pair.second.size();
+        for (uint64_t playerID = 0; playerID < player_hands.size(); playerID++) {
+            uint64_t cardsLeft = bitboard::popcount(player_hands[playerID]);
             
             // Add to player's total
             player_total_cards[playerID] += cardsLeft;
@@ -263,6 +437,8 @@ MyGameMapper::runMultipleRounds(bool displayOutput) {
         }
     }
     
+    steady_state_allocations = total_rounds >= 2 ? allocations::count() - allocationsBefore : 0;
+    
     // Game over - display final results
     if (displayOutput) {
         displayFinalResults();
@@ -302,15 +478,17 @@ void MyGameMapper::displayFinalResults() {
 
 // Get final standings based on total cards (fewer is better)
 std::vector<std::pair<uint64_t, uint64_t>> MyGameMapper::getFinalStandings() {
-    // Convert map to vector for sorting
+    // Pair every player with their total for sorting
     std::vector<std::pair<uint64_t, uint64_t>> cardCounts;
-    for (const auto& pair : player_total_cards) {
-        cardCounts.push_back(pair);
+    for (uint64_t playerID = 0; playerID < player_total_cards.size(); playerID++) {
+        cardCounts.push_back({playerID, player_total_cards[playerID]});
     }
     
-    // Sort by total cards (ascending)
+    // Sort by total cards (ascending), ties in seat order
     std::sort(cardCounts.begin(), cardCounts.end(),
-              [](const auto& a, const auto& b) { return a.second < b.second; });
+              [](const auto& a, const auto& b) {
+                  return a.second != b.second ? a.second < b.second : a.first < b.first;
+              });
     
     // Convert to standings (playerID, rank)
     std::vector<std::pair<uint64_t, uint64_t>> standings;
@@ -323,68 +501,60 @@ std::vector<std::pair<uint64_t, uint64_t>> MyGameMapper::getFinalStandings() {
 
 // Play a single round until one player empties their hand
 uint64_t MyGameMapper::playRound(bool displayOutput) {
-    std::vector<uint64_t> player_order;
-    
-    // Create initial player order
-    for (const auto& pair : player_hands) {
-        player_order.push_back(pair.first);
-    }
-    std::sort(player_order.begin(), player_order.end());
-    
+    // Players take turns in seat order
+    uint64_t numSeats = player_hands.size();
     uint64_t current_player_idx = 0;
     uint64_t consecutive_passes = 0;
+    
+    // Reset the pass history reported in GameView
+    round_turn = 0;
+    passed_since_play = 0;
+    round_pass_counts.fill(0);
     uint64_t winner = UINT64_MAX; // Invalid player ID to indicate no winner yet
     
     // Game loop - continue until someone empties their hand or the game is blocked
     while (winner == UINT64_MAX) {
-        uint64_t playerID = player_order[current_player_idx];
+        uint64_t playerID = current_player_idx;
         
         // Skip players who have emptied their hand (should never happen in this implementation)
-        if (player_hands[playerID].empty()) {
-            current_player_idx = (current_player_idx + 1) % player_order.size();
+        if (player_hands[playerID] == 0) {
+            current_player_idx = (current_player_idx + 1) % numSeats;
             continue;
         }
         
         if (displayOutput) {
             std::cout << "Player " << playerID << "'s turn. ";
-            std::cout << "Hand size: " << player_hands[playerID].size() << std::endl;
+            std::cout << "Hand size: " << bitboard::popcount(player_hands[playerID]) << std::endl;
         }
         
-        // Get the player's strategy
-        auto& strategy = player_strategies[playerID];
-        
         // Ask the strategy to select a card
-        int card_idx = strategy->selectCardToPlay(player_hands[playerID], table_layout);
+        int card_bit = askStrategy(playerID);
+        round_turn++;
         
-        if (card_idx == -1 || card_idx >= static_cast<int>(player_hands[playerID].size())) {
+        if (card_bit < 0 || card_bit >= 64) {
             // Player passes
             if (displayOutput) {
                 std::cout << "Player " << playerID << " passes" << std::endl;
             }
             
-            // Inform other strategies of the pass
-            for (const auto& pair : player_strategies) {
-                if (pair.first != playerID) {
-                    pair.second->observePass(playerID);
-                }
+            if (game_recorder) {
+                game_recorder->pass();
             }
             
+            // Inform other strategies of the pass
+            broadcastPass(playerID);
+            
+            recordPass(playerID);
             consecutive_passes++;
             
             // Check if game is blocked (all players passed)
-            if (consecutive_passes >= player_order.size()) {
+            if (consecutive_passes >= numSeats) {
                 // Check if any player has a playable card
-                bool gameBlocked = true;
-                
-                for (const auto& pair : player_hands) {
-                    for (const Card& card : pair.second) {
-                        if (isPlayable(card)) {
-                            gameBlocked = false;
-                            break;
-                        }
-                    }
-                    if (!gameBlocked) break;
+                CardMask allHands = 0;
+                for (CardMask hand : player_hands) {
+                    allHands |= hand;
                 }
+                bool gameBlocked = moves::legalMoves(allHands, table_bits) == 0;
                 
                 if (gameBlocked) {
                     // No one can play - round is over with no winner
@@ -396,29 +566,29 @@ uint64_t MyGameMapper::playRound(bool displayOutput) {
             }
         } else {
             // Player plays a card
-            Card played_card = player_hands[playerID][card_idx];
+            Card played_card = bitboard::cardAt(card_bit);
             
-            // Check if the card is actually playable
-            if (isPlayable(played_card)) {
+            // Check if the card is in the player's hand and actually playable
+            if ((player_hands[playerID] >> card_bit & 1) && isPlayable(played_card)) {
                 if (displayOutput) {
                     displayCardPlay(playerID, played_card);
                 }
                 
+                if (game_recorder) {
+                    game_recorder->play(card_bit);
+                }
+                
                 // Update the table layout
-                table_layout[played_card.suit][played_card.rank] = true;
+                table_bits |= bitboard::cardMask(played_card);
                 
                 // Inform other strategies of the move
-                for (const auto& pair : player_strategies) {
-                    if (pair.first != playerID) {
-                        pair.second->observeMove(playerID, played_card);
-                    }
-                }
+                broadcastMove(playerID, played_card);
                 
                 // Remove the card from the player's hand
-                player_hands[playerID].erase(player_hands[playerID].begin() + card_idx);
+                player_hands[playerID] &= ~bitboard::cardMask(played_card);
                 
                 // Check if player has emptied their hand - this ends the round
-                if (player_hands[playerID].empty()) {
+                if (player_hands[playerID] == 0) {
                     if (displayOutput) {
                         std::cout << "Player " << playerID << " has emptied their hand and wins the round!" << std::endl;
                     }
@@ -427,24 +597,25 @@ uint64_t MyGameMapper::playRound(bool displayOutput) {
                 }
                 
                 consecutive_passes = 0;
+                passed_since_play = 0;
             } else {
                 // Invalid move (card not playable) - treat as a pass
                 if (displayOutput) {
                     std::cout << "Player " << playerID << " attempted to play an invalid card. Treated as a pass." << std::endl;
                 }
                 
-                for (const auto& pair : player_strategies) {
-                    if (pair.first != playerID) {
-                        pair.second->observePass(playerID);
-                    }
+                if (game_recorder) {
+                    game_recorder->pass();
                 }
+                broadcastPass(playerID);
                 
+                recordPass(playerID);
                 consecutive_passes++;
             }
         }
         
         // Move to the next player
-        current_player_idx = (current_player_idx + 1) % player_order.size();
+        current_player_idx = (current_player_idx + 1) % numSeats;
     }
     
     return winner;
@@ -469,9 +640,7 @@ void MyGameMapper::displayTableState() const {
         std::cout << std::left << std::setw(10) << suit_names[suit] << ": ";
         
         for (int rank = 1; rank <= 13; rank++) {
-            if (table_layout.count(suit) > 0 && 
-                table_layout.at(suit).count(rank) > 0 && 
-                table_layout.at(suit).at(rank)) {
+            if (bitboard::contains(table_bits, suit, rank)) {
                 
                 // Special formatting for 7s and face cards
                 if (rank == 7) {
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "Generic_game_mapper.hpp"
+#include "GameRecord.hpp"
 #include "PlayerStrategy.hpp"
-#include <random>
+#include "PlayerStrategyV2.hpp"
+#include "RngStream.hpp"
+#include "TimeControl.hpp"
+#include <array>
 #include <unordered_map>
 #include <vector>
 #include <memory>
@@ -39,20 +43,78 @@ public:
     void read_cards(const std::string& filename) override;
     void read_game(const std::string& filename) override;
     
-    // Strategy management
+    // Strategy management (version 1 strategies run behind LegacyStrategyAdapter)
     void registerStrategy(uint64_t playerID, std::shared_ptr<PlayerStrategy> strategy);
+    void registerStrategyV2(uint64_t playerID, std::shared_ptr<PlayerStrategyV2> strategy);
     bool hasRegisteredStrategies() const;
+    
+    // Reseed the game (for reproducible runs). Each round is dealt from
+    // derive(DEAL, round) and each seeded strategy gets derive(SEAT, id).
+    void setSeed(uint64_t seed);
+    void setRandomStream(const RngStream& stream);
+    
+    // Statistics of the last completed game
+    uint64_t getTotalRounds() const;
+    uint64_t getTotalCards(uint64_t playerID) const;
+    uint64_t getRoundsWon(uint64_t playerID) const;
+    
+    // Heap allocations made during rounds 2..N of the last game; the round
+    // loop is allocation-free once the first round has sized everything.
+    // Always 0 unless built with SEVENS_COUNT_ALLOCATIONS (AllocationCounter.hpp)
+    uint64_t getSteadyStateAllocations() const;
+    
+    // Per-seat thinking limits, passed to strategies implementing
+    // AnytimeStrategy (others ignore them). Time banks refill every game.
+    void setTimeControl(uint64_t playerID, const TimeControl& control);
+    
+    // Seconds the seat spent deciding under its time control in the last game
+    double getThinkSeconds(uint64_t playerID) const;
+    
+    // Log every game played to `recorder` (null = no recording); each
+    // game replaces the previous log
+    void setRecorder(GameRecorder* recorder);
 
 private:
-    // Game state
-    std::mt19937 rng;
-    std::unordered_map<uint64_t, std::vector<Card>> player_hands;
-    std::unordered_map<uint64_t, std::shared_ptr<PlayerStrategy>> player_strategies;
+    // The microbenchmarks (Benchmark.cpp) time the round steps directly
+    friend class EngineBenchmark;
+    
+    // Game state, indexed by player ID (seats are dense: 0..N-1)
+    RngStream rng; // master stream of the game, only used to derive children
+    std::vector<CardMask> player_hands;
+    std::vector<std::shared_ptr<PlayerStrategyV2>> player_strategies;
+    
+    // Deck (card bits, without the 7 of Diamonds) built once from
+    // cards_hashmap, and the working copy reshuffled in place every round
+    std::vector<uint8_t> deck_template;
+    std::vector<uint8_t> deck;
+    
+    // Strategies that subscribed to move/pass broadcasts (player ID, strategy)
+    std::vector<std::pair<uint64_t, PlayerStrategyV2*>> move_subscribers;
+    std::vector<std::pair<uint64_t, PlayerStrategyV2*>> pass_subscribers;
+    
+    // Time controls by player ID, the seats' AnytimeStrategy interfaces
+    // (null if not implemented) and their time left and spent this game
+    std::vector<TimeControl> time_controls;
+    std::vector<AnytimeStrategy*> anytime_strategies;
+    
+    // The seats' DealOrderStrategy interfaces (null if not implemented)
+    std::vector<DealOrderStrategy*> deal_order_strategies;
+    std::vector<double> time_banks;
+    std::vector<double> think_seconds;
+    
+    // Record of the current game, if recording
+    GameRecorder* game_recorder = nullptr;
+    
+    // Turn and pass history of the current round (reported in GameView)
+    uint64_t round_turn = 0;
+    uint32_t passed_since_play = 0;
+    std::array<uint8_t, GameView::MAX_SEATS> round_pass_counts = {};
     
     // Game statistics
-    std::unordered_map<uint64_t, uint64_t> player_total_cards;
-    std::unordered_map<uint64_t, uint64_t> player_rounds_won;
+    std::vector<uint64_t> player_total_cards;
+    std::vector<uint64_t> player_rounds_won;
     uint64_t total_rounds;
+    uint64_t steady_state_allocations;
     
     // Helper constants
     static const uint64_t INVALID_PLAYER = UINT64_MAX;
@@ -60,12 +122,20 @@ private:
     // Game setup methods
     void resetTableLayout();
     void ensureStrategies(uint64_t numPlayers);
+    void buildDeck();
     void dealCards();
+    void seedStrategies();
+    void rebuildSubscribers();
     
     // Game logic methods
     std::vector<std::pair<uint64_t, uint64_t>> runMultipleRounds(bool displayOutput);
     uint64_t playRound(bool displayOutput);
     bool isPlayable(const Card& card) const;
+    GameView makeView(uint64_t playerID);
+    int askStrategy(uint64_t playerID);
+    void recordPass(uint64_t playerID);
+    void broadcastMove(uint64_t playerID, const Card& card);
+    void broadcastPass(uint64_t playerID);
     
     // Display and statistics methods
     void displayCardPlay(uint64_t playerID, const Card& card);
@@ -0,0 +1,190 @@
+// PIMCStrategy.cpp
+#include "PIMCStrategy.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+
+namespace sevens {
+
+namespace {
+
+uint64_t readSetting(const char* name, uint64_t fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+} // namespace
+
+PIMCConfig PIMCConfig::fromEnvironment() {
+    PIMCConfig config;
+    config.samples = static_cast<int>(readSetting("PIMC_SAMPLES", config.samples));
+    config.rollouts = static_cast<int>(readSetting("PIMC_ROLLOUTS", config.rollouts));
+    config.threads = static_cast<unsigned>(readSetting("PIMC_THREADS", config.threads));
+    config.timeBudgetMs = static_cast<double>(readSetting("PIMC_TIME_MS", 0));
+    return config;
+}
+
+PIMCStrategy::PIMCStrategy() : PIMCStrategy(PIMCConfig::fromEnvironment()) {}
+
+PIMCStrategy::PIMCStrategy(const PIMCConfig& config) : settings(config) {
+    if (settings.samples < 1) settings.samples = 1;
+    if (settings.rollouts < 1) settings.rollouts = 1;
+    if (settings.threads < 1) settings.threads = 1;
+
+    auto seed = static_cast<uint64_t>(
+        std::chrono::system_clock::now().time_since_epoch().count()
+    );
+    rng = RngStream(seed);
+    pool = std::make_unique<WorkerPool>(settings.threads);
+    workerTotals.resize(settings.threads);
+}
+
+PIMCStrategy::~PIMCStrategy() = default;
+
+void PIMCStrategy::seedRandom(const RngStream& stream) {
+    rng = stream;
+}
+
+void PIMCStrategy::initialize(uint64_t playerID) {
+    myID = playerID;
+    highestSeat = std::max(highestSeat, playerID);
+}
+
+int PIMCStrategy::selectCardToPlay(
+    const std::vector<Card>& hand,
+    const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout)
+{
+    // The version 1 interface does not say how many players there are:
+    // assume the seats seen so far
+    CardMask table = bitboard::fromTableLayout(tableLayout);
+    beliefs.syncTable(table);
+    GameView view = GameState::guessView(bitboard::fromCards(hand), table,
+                                         static_cast<int>(myID), static_cast<int>(highestSeat + 1));
+    int bit = chooseCard(view, defaultBudget());
+    if (bit < 0) {
+        return -1;
+    }
+    for (int i = 0; i < static_cast<int>(hand.size()); i++) {
+        if (bitboard::cardBit(hand[i].suit, hand[i].rank) == bit) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int PIMCStrategy::selectCard(GameView view) {
+    beliefs.sync(view);
+    return chooseCard(view, defaultBudget());
+}
+
+int PIMCStrategy::selectCardWithin(GameView view, const SearchBudget& budget) {
+    beliefs.sync(view);
+    return chooseCard(view, budget.limited() ? budget : defaultBudget());
+}
+
+SearchBudget PIMCStrategy::defaultBudget() const {
+    SearchBudget budget;
+    if (settings.timeBudgetMs > 0) {
+        budget = SearchBudget::within(settings.timeBudgetMs / 1000.0);
+    }
+    budget.nodes = static_cast<uint64_t>(settings.samples);
+    return budget;
+}
+
+int PIMCStrategy::chooseCard(const GameView& view, const SearchBudget& budget) {
+    moves::PlayableList candidates = moves::toList(view.legalMoves());
+    if (candidates.empty()) {
+        return -1;
+    }
+    if (candidates.size() == 1) {
+        return candidates[0];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const int maxSamples = budget.nodes && budget.nodes < INT_MAX ? static_cast<int>(budget.nodes) : INT_MAX;
+
+    // Deal i always draws from decision.derive(i), whichever worker takes it
+    const RngStream decision = rng.derive(rng());
+    const int seat = view.seat;
+    const int numCandidates = candidates.size();
+    const DealSampler sampler(view, &beliefs);
+    std::atomic<int> nextSample{0};
+
+    auto job = [&](unsigned worker) {
+        WorkerTotals& mine = workerTotals[worker];
+        std::fill(mine.value, mine.value + moves::MAX_PLAYABLE, 0);
+        mine.samples = 0;
+        mine.deals = DealStats();
+
+        for (;;) {
+            int sample = nextSample.fetch_add(1, std::memory_order_relaxed);
+            if (sample >= maxSamples) break;
+            if (sample > 0 && budget.expired()) break;
+
+            RngStream sampleRng = decision.derive(sample);
+            const GameState deal = sampler.sample(sampleRng, &mine.deals);
+            for (int c = 0; c < numCandidates; c++) {
+                for (int r = 0; r < settings.rollouts; r++) {
+                    GameState state = deal;
+                    state.makeMove(candidates[c]);
+                    if (state.hands[seat] != 0) {
+                        state.playRandomly(sampleRng);
+                    }
+                    mine.value[c] -= state.cardsLeft(seat);
+                }
+            }
+            mine.samples++;
+        }
+    };
+    pool->run(job);
+
+    // Fewest cards left on average over the deals, lowest card on ties
+    int64_t value[moves::MAX_PLAYABLE] = {};
+    uint64_t samples = 0;
+    for (const WorkerTotals& worker : workerTotals) {
+        for (int c = 0; c < numCandidates; c++) {
+            value[c] += worker.value[c];
+        }
+        samples += worker.samples;
+        totals.deals.add(worker.deals);
+    }
+    int best = 0;
+    for (int c = 1; c < numCandidates; c++) {
+        if (value[c] > value[best]) {
+            best = c;
+        }
+    }
+
+    totals.decisions++;
+    totals.samples += samples;
+    totals.rollouts += samples * numCandidates * settings.rollouts;
+    totals.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return candidates[best];
+}
+
+void PIMCStrategy::observeMove(uint64_t playerID, const Card& playedCard) {
+    highestSeat = std::max(highestSeat, playerID);
+    beliefs.observeMove(playerID, playedCard);
+}
+
+void PIMCStrategy::observePass(uint64_t playerID) {
+    highestSeat = std::max(highestSeat, playerID);
+    beliefs.observePass(playerID);
+}
+
+std::string PIMCStrategy::getName() const {
+    return "PIMCStrategy";
+}
+
+} // namespace sevens
+
+#ifdef BUILD_SHARED_LIB
+extern "C" sevens::PlayerStrategy* createStrategy() {
+    return new sevens::PIMCStrategy();
+}
+
+extern "C" sevens::PlayerStrategyV2* createStrategyV2() {
+    return new sevens::PIMCStrategy();
+}
+#endif
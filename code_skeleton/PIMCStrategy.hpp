@@ -0,0 +1,115 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include "PlayerStrategyV2.hpp"
+#include "GameState.hpp"
+#include "BeliefTracker.hpp"
+#include "DealSampler.hpp"
+#include "LegalMoves.hpp"
+#include "RngStream.hpp"
+#include "WorkerPool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+// Settings of PIMCStrategy
+struct PIMCConfig {
+    int samples = 64;          // deals of the unseen cards per decision
+    int rollouts = 1;          // playouts of every candidate on each deal
+    unsigned threads = 1;      // rollout threads, including the caller
+    double timeBudgetMs = 0;   // stop sampling after this long (0 = no limit)
+
+    // Read from PIMC_SAMPLES, PIMC_ROLLOUTS, PIMC_THREADS and PIMC_TIME_MS
+    // (unset ones keep the defaults)
+    static PIMCConfig fromEnvironment();
+};
+
+// Work done by a PIMCStrategy since it was created
+struct PIMCStats {
+    uint64_t decisions = 0;   // decisions with more than one legal move
+    uint64_t samples = 0;     // deals evaluated
+    uint64_t rollouts = 0;
+    double seconds = 0.0;
+    DealStats deals;
+};
+
+/**
+ * Perfect Information Monte Carlo (PIMC): at every decision with a choice,
+ * deal the unseen cards to the other seats in the numbers they hold and
+ * as their passes allow (DealSampler), play every candidate card on each deal followed by
+ * random playouts to the end of the round, and play the card that leaves
+ * us the fewest cards on average.
+ *
+ * All candidates are rolled out on the same deals, so the comparison
+ * between them is not blurred by the luck of the deal. Deals are split
+ * between the threads of a WorkerPool; each deal draws from its own
+ * stream derived from the decision's, so without a time budget the choice
+ * does not depend on the number of threads. Rollouts run on a GameState
+ * on the stack and do not allocate.
+ *
+ * The time budget caps each decision; at least one deal is always used.
+ * More samples or rollouts (or threads) buy strength with CPU time.
+ */
+class PIMCStrategy : public PlayerStrategy, public PlayerStrategyV2, public SeededStrategy,
+                     public AnytimeStrategy {
+public:
+    PIMCStrategy();
+    explicit PIMCStrategy(const PIMCConfig& config);
+    ~PIMCStrategy() override;
+
+    // PlayerStrategy interface
+    void initialize(uint64_t playerID) override;
+    int selectCardToPlay(
+        const std::vector<Card>& hand,
+        const std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>>& tableLayout) override;
+    void observeMove(uint64_t playerID, const Card& playedCard) override;
+    void observePass(uint64_t playerID) override;
+    std::string getName() const override;
+
+    // PlayerStrategyV2 interface
+    int selectCard(GameView view) override;
+
+    // SeededStrategy interface
+    void seedRandom(const RngStream& stream) override;
+
+    // AnytimeStrategy interface (one work unit = one deal)
+    int selectCardWithin(GameView view, const SearchBudget& budget) override;
+
+    const PIMCConfig& config() const { return settings; }
+    const PIMCStats& stats() const { return totals; }
+
+private:
+    // Rollout totals of one worker, on its own cache line
+    struct alignas(64) WorkerTotals {
+        int64_t value[moves::MAX_PLAYABLE];
+        uint64_t samples;
+        DealStats deals;
+    };
+
+    uint64_t myID = 0;
+    RngStream rng;
+    PIMCConfig settings;
+    PIMCStats totals;
+    std::unique_ptr<WorkerPool> pool;
+    std::vector<WorkerTotals> workerTotals;
+
+    // Highest seat seen playing or passing, for the version 1 interface
+    uint64_t highestSeat = 0;
+
+    // Cards ruled out for the other seats by their passes; deals are
+    // drawn to agree with it
+    BeliefTracker beliefs;
+
+    // The budget given by the settings
+    SearchBudget defaultBudget() const;
+
+    // Card bit to play for view.seat, or -1 to pass
+    int chooseCard(const GameView& view, const SearchBudget& budget);
+};
+
+} // namespace sevens
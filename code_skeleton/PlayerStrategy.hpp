@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Generic_card_parser.hpp"
+#include "RngStream.hpp"
 #include <vector>
 #include <memory>
 
@@ -33,6 +34,21 @@ public:
     virtual std::string getName() const = 0;
 };
 
+/**
+ * Optional interface for strategies that use random numbers.
+ * At the start of every game the engine hands each seat its own stream,
+ * derived from the engine's seed, so whole games can be reproduced.
+ * Kept separate from PlayerStrategy so that libraries built against the
+ * original interface still load; the engine detects it with dynamic_cast.
+ */
+class SeededStrategy {
+public:
+    virtual ~SeededStrategy() = default;
+    
+    // Replace the strategy's random state with this stream
+    virtual void seedRandom(const RngStream& stream) = 0;
+};
+
 // Type for strategy factory functions (for dynamic loading)
 typedef PlayerStrategy* (*CreateStrategyFn)();
 
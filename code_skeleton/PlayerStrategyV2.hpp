@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Generic_card_parser.hpp"
+#include "Bitboard.hpp"
+#include "LegalMoves.hpp"
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace sevens {
+
+// Version of the strategy interface declared in this header
+constexpr uint32_t STRATEGY_ABI_VERSION = 2;
+
+/**
+ * Everything a strategy needs to know about the game at its turn, packed
+ * into 64 bytes and passed by value. Card sets are bitboards (see
+ * Bitboard.hpp); per-seat arrays are indexed by player ID and only cover
+ * the first MAX_SEATS seats. The struct keeps its natural 8-byte
+ * alignment: an over-aligned by-value parameter is passed differently by
+ * different GCC versions, which a plugin interface cannot afford.
+ */
+struct GameView {
+    static constexpr int MAX_SEATS = 16;
+
+    CardMask hand;                  // cards in our hand
+    CardMask table;                 // cards on the table
+    CardMask played;                // cards played this round (table minus the starting 7)
+    uint16_t turn;                  // turns taken this round (plays and passes)
+    uint8_t seat;                   // our player ID
+    uint8_t numPlayers;
+    uint32_t passedSinceLastPlay;   // bit p set: seat p passed since the last card was played
+    uint8_t handCounts[MAX_SEATS];  // cards left in each seat's hand
+    uint8_t passCounts[MAX_SEATS];  // passes made by each seat this round
+
+    // Cards of our hand that may be played now
+    CardMask legalMoves() const {
+        return moves::legalMoves(hand, table);
+    }
+
+    // Cards anyone may play now (the two ends of every row plus unplayed 7s)
+    CardMask frontier() const {
+        return moves::playableCards(table);
+    }
+
+    int suitCount(int suit) const {
+        return bitboard::popcount(hand & bitboard::suitMask(suit));
+    }
+};
+
+static_assert(sizeof(GameView) == 64, "GameView must stay 64 bytes");
+
+// Events a strategy can subscribe to (see PlayerStrategyV2::subscribedEvents)
+namespace events {
+constexpr uint32_t NONE = 0;
+constexpr uint32_t MOVES = 1u << 0;   // observeMove
+constexpr uint32_t PASSES = 1u << 1;  // observePass
+constexpr uint32_t ALL = MOVES | PASSES;
+}
+
+/**
+ * Version 2 of the player strategy interface.
+ * Compared to PlayerStrategy, the hand and table are passed as a GameView
+ * and the strategy answers with a card instead of a position in a vector.
+ * Libraries export it with `createStrategyV2`; libraries that only export
+ * `createStrategy` are wrapped in LegacyStrategyAdapter by the loader.
+ */
+class PlayerStrategyV2 {
+public:
+    virtual ~PlayerStrategyV2() = default;
+
+    // Initialize the strategy with player ID and any other setup
+    virtual void initialize(uint64_t playerID) = 0;
+
+    // Select a card to play from view.hand
+    // Returns its bit index (bitboard::cardBit), or -1 to pass
+    virtual int selectCard(GameView view) = 0;
+
+    // Called to inform the strategy about other players' moves
+    virtual void observeMove(uint64_t playerID, const Card& playedCard) = 0;
+
+    // Called when a player passes their turn
+    virtual void observePass(uint64_t playerID) = 0;
+
+    // Get a name for this strategy (for display purposes)
+    virtual std::string getName() const = 0;
+
+    // Which of observeMove/observePass the engine should call (events::*).
+    // Queried when the strategy is registered; stateless strategies return
+    // events::NONE so the engine skips them when broadcasting.
+    virtual uint32_t subscribedEvents() const {
+        return events::ALL;
+    }
+};
+
+/**
+ * Limits on the work a strategy may spend on one decision: a deadline on
+ * the steady clock, a number of work units (rollouts, search iterations,
+ * ... as the strategy defines them), or both. A zero field is no limit.
+ * Plain integers, so the struct means the same on both sides of a library
+ * boundary.
+ */
+struct SearchBudget {
+    int64_t deadlineNs = 0;   // steady_clock time since its epoch, in ns
+    uint64_t nodes = 0;
+
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // A budget ending `seconds` from now
+    static SearchBudget within(double seconds) {
+        SearchBudget budget;
+        budget.deadlineNs = now() + static_cast<int64_t>(seconds * 1e9);
+        return budget;
+    }
+
+    bool timed() const { return deadlineNs != 0; }
+    bool limited() const { return deadlineNs != 0 || nodes != 0; }
+    bool expired() const { return deadlineNs != 0 && now() >= deadlineNs; }
+};
+
+/**
+ * Optional interface for strategies that can think for as long as they
+ * are allowed to (anytime search). The engine calls selectCardWithin
+ * instead of selectCard when a time control is set for the seat; the
+ * strategy should keep improving its choice until the budget runs out
+ * and then return the best card found so far.
+ *
+ * Like SeededStrategy, this and the other optional interfaces below are
+ * found on a strategy with dynamic_cast; the engine looks this one up
+ * when the strategy is registered.
+ */
+class AnytimeStrategy {
+public:
+    virtual ~AnytimeStrategy() = default;
+
+    // Same contract as PlayerStrategyV2::selectCard, within `budget`
+    virtual int selectCardWithin(GameView view, const SearchBudget& budget) = 0;
+};
+
+/**
+ * Optional interface for strategies that need their hand in the order it
+ * was dealt, which a GameView does not carry: the version 1 interface
+ * hands out cards in that order, and the strategies written against it
+ * (Greedy, for one) play by it. After every deal the engine passes the
+ * card bits of the deck in the order they were dealt; a seat's hand in
+ * deal order is the deck filtered by view.hand.
+ */
+class DealOrderStrategy {
+public:
+    virtual ~DealOrderStrategy() = default;
+
+    // `cards` stays valid until the next call
+    virtual void setDealOrder(const uint8_t* cards, size_t count) = 0;
+};
+
+/**
+ * Optional interface for strategies whose play is steered by numeric
+ * weights, so that a tuner can set them from outside. Parameters are
+ * numbered from 0 and named for parameter files. The tune command
+ * refuses a strategy without it.
+ */
+class TunableStrategy {
+public:
+    virtual ~TunableStrategy() = default;
+
+    virtual int parameterCount() const = 0;
+    virtual std::string parameterName(int index) const = 0;
+    virtual double getParameter(int index) const = 0;
+    virtual void setParameter(int index, double value) = 0;
+};
+
+// Type for version 2 strategy factory functions (for dynamic loading)
+typedef PlayerStrategyV2* (*CreateStrategyV2Fn)();
+
+} // namespace sevens
@@ -1,5 +1,6 @@
 // RandomStrategy.cpp
 #include "RandomStrategy.hpp"
+#include "LegalMoves.hpp"
 #include <algorithm>
 #include <vector>
 #include <chrono>
@@ -10,10 +11,14 @@ namespace sevens {
 
 // Constructor seeds the RNG
 RandomStrategy::RandomStrategy() {
-    auto seed = static_cast<unsigned long>(
+    auto seed = static_cast<uint64_t>(
         std::chrono::system_clock::now().time_since_epoch().count()
     );
-    rng.seed(seed);
+    rng = RngStream(seed);
+}
+
+void RandomStrategy::seedRandom(const RngStream& stream) {
+    rng = stream;
 }
 
 void RandomStrategy::initialize(uint64_t playerID) {
@@ -30,44 +35,8 @@ int RandomStrategy::selectCardToPlay(
     }
 
     // Find playable cards in the hand
-    std::vector<int> playableCardIndices;
-    for (int i = 0; i < static_cast<int>(hand.size()); i++) {
-        const Card& card = hand[i];
-        int suit = card.suit;
-        int rank = card.rank;
-        
-        // Skip cards we know are not playable
-        // Special case: 7s can be played only if not already on the table
-        if (rank == 7) {
-            // Check if this 7 is already on the table
-            if (tableLayout.count(suit) > 0 && 
-                tableLayout.at(suit).count(rank) > 0 && 
-                tableLayout.at(suit).at(rank)) {
-                // This 7 is already on the table, cannot play it
-                continue;
-            } else {
-                // This 7 is not on the table, can play it
-                playableCardIndices.push_back(i);
-                continue;
-            }
-        }
-        
-        // Check if rank+1 is on the table
-        bool higher = (rank < 13 && 
-                      tableLayout.count(suit) > 0 && 
-                      tableLayout.at(suit).count(rank+1) > 0 && 
-                      tableLayout.at(suit).at(rank+1));
-                      
-        // Check if rank-1 is on the table
-        bool lower = (rank > 1 && 
-                     tableLayout.count(suit) > 0 && 
-                     tableLayout.at(suit).count(rank-1) > 0 && 
-                     tableLayout.at(suit).at(rank-1));
-        
-        if (higher || lower) {
-            playableCardIndices.push_back(i);
-        }
-    }
+    moves::PlayableList playableCardIndices =
+        moves::playableIndices(hand, bitboard::fromTableLayout(tableLayout));
     
     // If no playable cards, pass
     if (playableCardIndices.empty()) {
@@ -75,11 +44,22 @@ int RandomStrategy::selectCardToPlay(
     }
     
     // Select a random playable card
-    std::uniform_int_distribution<int> dist(0, static_cast<int>(playableCardIndices.size()) - 1);
-    int randomIndex = dist(rng);
+    int randomIndex = static_cast<int>(rng.below(playableCardIndices.size()));
     return playableCardIndices[randomIndex];
 }
 
+int RandomStrategy::selectCard(GameView view) {
+    moves::PlayableList playable = moves::toList(view.legalMoves());
+    
+    // If no playable cards, pass
+    if (playable.empty()) {
+        return -1;
+    }
+    
+    // Select a random playable card
+    return playable[rng.below(playable.size())];
+}
+
 void RandomStrategy::observeMove(uint64_t /*playerID*/, const Card& /*playedCard*/) {
     // This simplified strategy ignores other players' moves
 }
@@ -88,6 +68,11 @@ void RandomStrategy::observePass(uint64_t /*playerID*/) {
     // This simplified strategy ignores passes
 }
 
+uint32_t RandomStrategy::subscribedEvents() const {
+    // Other players' moves and passes are ignored
+    return events::NONE;
+}
+
 std::string RandomStrategy::getName() const {
     return "RandomStrategy";
 }
@@ -102,4 +87,8 @@ std::string RandomStrategy::getName() const {
 extern "C" sevens::PlayerStrategy* createStrategy() {
     return new sevens::RandomStrategy();
 }
+
+extern "C" sevens::PlayerStrategyV2* createStrategyV2() {
+    return new sevens::RandomStrategy();
+}
 #endif
\ No newline at end of file
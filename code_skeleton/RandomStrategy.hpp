@@ -2,6 +2,7 @@
 
 #include "Generic_game_mapper.hpp"
 #include "PlayerStrategy.hpp"
+#include "PlayerStrategyV2.hpp"
 #include "RandomStrategy.hpp"  // Add this
 #include <random>
 #include <unordered_map>
@@ -14,7 +15,7 @@ namespace sevens {
 /**
  * A simple strategy that selects a random playable card.
  */
-class RandomStrategy : public PlayerStrategy {
+class RandomStrategy : public PlayerStrategy, public PlayerStrategyV2, public SeededStrategy {
 public:
     RandomStrategy();
     ~RandomStrategy() override = default;
@@ -28,9 +29,16 @@ public:
     void observePass(uint64_t playerID) override;
     std::string getName() const override;
     
+    // PlayerStrategyV2 interface
+    int selectCard(GameView view) override;
+    uint32_t subscribedEvents() const override;
+    
+    // SeededStrategy interface
+    void seedRandom(const RngStream& stream) override;
+    
 private:
     uint64_t myID;
-    std::mt19937 rng;
+    RngStream rng;
 };
 
 } // namespace sevens
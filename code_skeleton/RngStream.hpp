@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+namespace sevens {
+
+/**
+ * Small, fast, splittable random number stream (SplitMix64).
+ *
+ * The whole state is one 64-bit counter, so streams are cheap to copy and
+ * to hand out. derive(key) returns an independent child stream that only
+ * depends on this stream's state and the key, which lets a game, a round
+ * and a seat each get their own stream from one master seed without any
+ * coordination (and identically on every thread).
+ *
+ * Meets the UniformRandomBitGenerator requirements, but what std::shuffle
+ * and the std distributions make of its numbers differs between standard
+ * libraries. The engine and strategies draw through below(), uniform()
+ * and shuffle() instead, so a seed plays the same games with libstdc++,
+ * libc++ and MSVC.
+ */
+class RngStream {
+public:
+    typedef uint64_t result_type;
+
+    explicit RngStream(uint64_t seed = 0) : state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        state += GOLDEN_GAMMA;
+        return mix(state);
+    }
+
+    // Independent child stream for `key` (derive before drawing from a
+    // stream that is used as a parent)
+    RngStream derive(uint64_t key) const {
+        return RngStream(mix(state ^ mix(key + GOLDEN_GAMMA)));
+    }
+
+    RngStream derive(uint64_t key1, uint64_t key2) const {
+        return derive(key1).derive(key2);
+    }
+
+    // Current state; RngStream(s.seed()) reproduces s
+    uint64_t seed() const { return state; }
+
+    // Uniform integer in [0, bound) (bound > 0), without modulo bias worth
+    // caring about for card-game bounds (Lemire's multiply-shift)
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+
+    // Uniform double in [0, 1): the top 53 bits, scaled exactly
+    double uniform() {
+        return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Fisher-Yates shuffle of [first, last), drawing with below()
+    template <typename RandomIt>
+    void shuffle(RandomIt first, RandomIt last) {
+        for (auto i = last - first; i > 1; i--) {
+            std::swap(first[i - 1], first[below(static_cast<uint32_t>(i))]);
+        }
+    }
+
+private:
+    static constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state;
+};
+
+// Keys used by the engine to split its game stream
+namespace streams {
+constexpr uint64_t DEAL = 1;  // derive(DEAL, round) shuffles the deck of a round
+constexpr uint64_t SEAT = 2;  // derive(SEAT, playerID) is handed to a strategy
+}
+
+} // namespace sevens
@@ -0,0 +1,169 @@
+// SPRT.cpp
+#include "SPRT.hpp"
+#include "RngStream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+
+namespace sevens {
+
+namespace {
+
+// Games per chunk handed to a GameSimulator worker
+const uint64_t PAIRS_PER_THREAD = 64;
+
+// Variance floor: a run where every pair scored the same still decides
+const double MIN_VARIANCE = 1e-6;
+
+// A's points in one game against B
+double gameScore(uint64_t cardsA, uint64_t cardsB) {
+    return cardsA < cardsB ? 1.0 : cardsA == cardsB ? 0.5 : 0.0;
+}
+
+} // namespace
+
+SPRT::SPRT(const SPRTConfig& config)
+    : score0(eloToScore(config.elo0)), score1(eloToScore(config.elo1)),
+      lower(std::log(config.beta / (1.0 - config.alpha))),
+      upper(std::log((1.0 - config.beta) / config.alpha)) {
+}
+
+double SPRT::scoreToElo(double score) {
+    score = std::min(std::max(score, 1e-9), 1.0 - 1e-9);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double SPRT::eloToScore(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+void SPRT::add(double pairScore) {
+    int index = static_cast<int>(std::lround(pairScore * 2.0));
+    counts[std::min(std::max(index, 0), 4)]++;
+}
+
+uint64_t SPRT::pairs() const {
+    uint64_t total = 0;
+    for (uint64_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+// Mean score per game, 0 to 1
+double SPRT::mean() const {
+    uint64_t total = pairs();
+    if (!total) return 0.5;
+    double sum = 0.0;
+    for (int i = 0; i < 5; i++) {
+        sum += counts[i] * (i / 4.0);
+    }
+    return sum / total;
+}
+
+// Variance of the per-game score of one pair
+double SPRT::variance() const {
+    uint64_t total = pairs();
+    if (!total) return MIN_VARIANCE;
+    double m = mean();
+    double sum = 0.0;
+    for (int i = 0; i < 5; i++) {
+        double d = i / 4.0 - m;
+        sum += counts[i] * d * d;
+    }
+    return std::max(sum / total, MIN_VARIANCE);
+}
+
+double SPRT::llr() const {
+    uint64_t total = pairs();
+    if (!total) return 0.0;
+    return total * (score1 - score0) * (2.0 * mean() - score0 - score1) / (2.0 * variance());
+}
+
+SPRT::Result SPRT::status() const {
+    double value = llr();
+    if (value >= upper) return ACCEPT_H1;
+    if (value <= lower) return ACCEPT_H0;
+    return CONTINUE;
+}
+
+double SPRT::elo() const {
+    return scoreToElo(mean());
+}
+
+double SPRT::eloMargin() const {
+    uint64_t total = pairs();
+    if (!total) return 0.0;
+    double halfWidth = 1.959964 * std::sqrt(variance() / total);
+    return (scoreToElo(std::min(mean() + halfWidth, 1.0)) - scoreToElo(std::max(mean() - halfWidth, 0.0))) / 2.0;
+}
+
+ABMatch::ABMatch(const MyGameMapper& prototypeEngine, StrategyFactory first, StrategyFactory second,
+                 std::vector<StrategyFactory> others, const SPRTConfig& config)
+    : prototype(prototypeEngine), settings(config) {
+    forward = {first, second};
+    swapped = {second, first};
+    forward.insert(forward.end(), others.begin(), others.end());
+    swapped.insert(swapped.end(), others.begin(), others.end());
+}
+
+SPRT::Result ABMatch::run(std::ostream& progress) {
+    unsigned numThreads = settings.threads ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+    uint64_t batch = settings.batchPairs ? settings.batchPairs : PAIRS_PER_THREAD * numThreads;
+    const uint64_t numSeats = forward.size();
+
+    SPRT test(settings);
+    progress << std::fixed << std::setprecision(2)
+             << "SPRT elo0 " << settings.elo0 << ", elo1 " << settings.elo1
+             << ", alpha " << settings.alpha << ", beta " << settings.beta
+             << ": LLR bounds [" << test.lowerBound() << ", " << test.upperBound() << "]\n";
+
+    GameSimulator first(prototype, forward);
+    GameSimulator second(prototype, swapped);
+    std::vector<uint64_t> cardsForward, cardsSwapped;
+    auto start = std::chrono::steady_clock::now();
+
+    SPRT::Result result = SPRT::CONTINUE;
+    for (uint64_t k = 0; result == SPRT::CONTINUE && test.pairs() < settings.maxPairs; k++) {
+        uint64_t count = std::min(batch, settings.maxPairs - test.pairs());
+        RngStream stream = RngStream(settings.seed).derive(k);
+        uint64_t seed = stream();
+
+        // Game i of both runs plays the same deals
+        first.run(count, seed, numThreads, &cardsForward);
+        second.run(count, seed, numThreads, &cardsSwapped);
+        for (uint64_t i = 0; i < count; i++) {
+            const uint64_t* a = &cardsForward[i * numSeats];
+            const uint64_t* b = &cardsSwapped[i * numSeats];
+            test.add(gameScore(a[0], a[1]) + gameScore(b[1], b[0]));
+        }
+        result = test.status();
+
+        const uint64_t* penta = test.pentanomial();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        progress << "Pairs " << test.pairs() << ": LLR " << std::setprecision(2) << test.llr()
+                 << ", Elo " << std::showpos << std::setprecision(1) << test.elo() << std::noshowpos
+                 << " +- " << test.eloMargin()
+                 << ", pentanomial [" << penta[0] << " " << penta[1] << " " << penta[2] << " "
+                 << penta[3] << " " << penta[4] << "] (" << seconds << "s)\n" << std::flush;
+    }
+
+    progress << "\n";
+    switch (result) {
+        case SPRT::ACCEPT_H1:
+            progress << "H1 accepted: A - B >= " << settings.elo1 << " Elo\n";
+            break;
+        case SPRT::ACCEPT_H0:
+            progress << "H0 accepted: A - B <= " << settings.elo0 << " Elo\n";
+            break;
+        case SPRT::CONTINUE:
+            progress << "Undecided after " << test.pairs() << " pairs\n";
+            break;
+    }
+    progress << "Games played: " << 2 * test.pairs() << "\n" << std::defaultfloat;
+    return result;
+}
+
+} // namespace sevens
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "GameSimulator.hpp"
+#include "MyGameMapper.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+// Hypotheses and error rates of a sequential A/B test
+struct SPRTConfig {
+    double elo0 = 0.0;          // H0: A is at most this much stronger than B
+    double elo1 = 20.0;         // H1: A is at least this much stronger
+    double alpha = 0.05;        // chance of accepting H1 when H0 holds
+    double beta = 0.05;         // chance of accepting H0 when H1 holds
+    uint64_t maxPairs = 100000; // stop undecided after this many game pairs
+    uint64_t batchPairs = 0;    // pairs between two looks at the test (0 = 64 per thread)
+    uint64_t seed = 0;
+    unsigned threads = 0;       // 0 = all cores
+};
+
+/**
+ * Sequential probability ratio test on paired games.
+ *
+ * A pair is two games on the same deals with A and B in swapped seats;
+ * its score for A is 0, 0.5, 1, 1.5 or 2 (a win is ending a game with
+ * fewer cards than B, a tie counts half). Pair scores are tallied in a
+ * pentanomial and the log-likelihood ratio of H1 against H0 uses the
+ * normal approximation of the generalized SPRT, with the variance
+ * measured from the pairs. Playing both seat orders on the same deals
+ * removes most of the luck of the cards from each pair, which is what
+ * makes the test stop early.
+ *
+ * Elo differences are logistic: a score rate s is -400 log10(1/s - 1).
+ */
+class SPRT {
+public:
+    enum Result { CONTINUE, ACCEPT_H0, ACCEPT_H1 };
+
+    explicit SPRT(const SPRTConfig& config);
+
+    // Add one pair of games; `pairScore` is A's points, 0 to 2 by halves
+    void add(double pairScore);
+
+    double llr() const;
+    double lowerBound() const { return lower; }
+    double upperBound() const { return upper; }
+    Result status() const;
+
+    uint64_t pairs() const;
+    const uint64_t* pentanomial() const { return counts; }
+
+    // Elo of A over B from the pairs so far, and the half-width of its
+    // 95% interval
+    double elo() const;
+    double eloMargin() const;
+
+    static double scoreToElo(double score);
+    static double eloToScore(double elo);
+
+private:
+    double score0, score1;
+    double lower, upper;
+    uint64_t counts[5] = {};
+
+    double mean() const;
+    double variance() const;
+};
+
+/**
+ * Plays A against B (plus any other seats, which keep their places) in
+ * batches of game pairs until the SPRT decides or maxPairs is reached,
+ * reporting the test after every batch. Batch k uses the seed
+ * RngStream(seed).derive(k), so a run can be repeated exactly.
+ */
+class ABMatch {
+public:
+    ABMatch(const MyGameMapper& prototypeEngine, StrategyFactory first, StrategyFactory second,
+            std::vector<StrategyFactory> others, const SPRTConfig& config);
+
+    SPRT::Result run(std::ostream& progress);
+
+private:
+    MyGameMapper prototype;
+    std::vector<StrategyFactory> forward;    // A in seat 0, B in seat 1
+    std::vector<StrategyFactory> swapped;    // B in seat 0, A in seat 1
+    SPRTConfig settings;
+};
+
+} // namespace sevens
@@ -0,0 +1,208 @@
+// SPSATuner.cpp
+#include "SPSATuner.hpp"
+#include "RngStream.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace sevens {
+
+namespace {
+
+// Standard SPSA gain exponents
+const double STEP_DECAY = 0.602;
+const double PERTURBATION_DECAY = 0.101;
+
+// Index of `name` in `names`, or -1
+int indexOf(const std::vector<std::string>& names, const std::string& name) {
+    auto it = std::find(names.begin(), names.end(), name);
+    return it == names.end() ? -1 : static_cast<int>(it - names.begin());
+}
+
+} // namespace
+
+SPSATuner::SPSATuner(const TunerConfig& config, std::vector<std::string> parameterNames,
+                     std::vector<double> initialValues, Objective objective)
+    : settings(config), names(std::move(parameterNames)), theta(std::move(initialValues)),
+      evaluate(std::move(objective)) {
+    if (settings.validateEvery < 1) settings.validateEvery = 1;
+    for (double value : theta) {
+        scale.push_back(value != 0.0 ? std::fabs(value) : 1.0);
+    }
+    best = theta;
+}
+
+bool SPSATuner::resume(std::string& error) {
+    std::ifstream in(checkpointPath());
+    if (!in) {
+        return true;   // nothing to resume
+    }
+
+    std::vector<double> loadedTheta = theta;
+    std::vector<double> loadedBest = best;
+    std::vector<bool> seen(names.size(), false);
+    int loadedIteration = 0;
+    double loadedCost = 0.0;
+    bool loadedHaveBest = false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "iteration") {
+            fields >> loadedIteration;
+        } else if (kind == "best_score") {
+            fields >> loadedCost;
+            loadedHaveBest = true;
+        } else if (kind == "theta" || kind == "best") {
+            std::string name;
+            double value;
+            fields >> name >> value;
+            int index = indexOf(names, name);
+            if (index < 0) {
+                error = checkpointPath() + ": unknown parameter " + name;
+                return false;
+            }
+            (kind == "theta" ? loadedTheta : loadedBest)[index] = value;
+            seen[index] = seen[index] || kind == "theta";
+        }
+        if (fields.fail()) {
+            error = checkpointPath() + ": cannot read \"" + line + "\"";
+            return false;
+        }
+    }
+    if (std::find(seen.begin(), seen.end(), false) != seen.end()) {
+        error = checkpointPath() + ": does not set every parameter";
+        return false;
+    }
+
+    theta = loadedTheta;
+    best = loadedBest;
+    bestCost = loadedCost;
+    haveBest = loadedHaveBest;
+    iteration = loadedIteration;
+    return true;
+}
+
+void SPSATuner::run(std::ostream& log) {
+    if (iteration > 0) {
+        log << "Resuming at iteration " << iteration << " from " << checkpointPath() << "\n";
+    }
+    if (!haveBest) {
+        validate(log);
+    }
+
+    // Stability constant of the step gain: a tenth of the run
+    const double stability = settings.iterations / 10.0;
+    const size_t count = theta.size();
+    std::vector<double> plus(count), minus(count);
+    std::vector<int> delta(count);
+
+    while (iteration < settings.iterations) {
+        RngStream stream = RngStream(settings.seed).derive(static_cast<uint64_t>(iteration));
+        double c = settings.perturbation / std::pow(iteration + 1.0, PERTURBATION_DECAY);
+        double a = settings.stepSize * std::pow((stability + 1.0) / (iteration + 1.0 + stability), STEP_DECAY);
+
+        for (size_t i = 0; i < count; i++) {
+            delta[i] = (stream() & 1) ? 1 : -1;
+            plus[i] = theta[i] + c * delta[i] * scale[i];
+            minus[i] = theta[i] - c * delta[i] * scale[i];
+        }
+
+        // Both sides play the same games
+        uint64_t gameSeed = stream();
+        double costPlus = evaluate(plus, gameSeed);
+        double costMinus = evaluate(minus, gameSeed);
+
+        for (size_t i = 0; i < count; i++) {
+            double gradient = (costPlus - costMinus) / (2.0 * c * delta[i]);
+            double step = std::max(-settings.maxStep, std::min(settings.maxStep, a * gradient));
+            theta[i] -= step * scale[i];
+        }
+        iteration++;
+
+        log << "Iteration " << iteration << "/" << settings.iterations << ": "
+            << std::fixed << std::setprecision(3) << costPlus << " (+) vs " << costMinus << " (-)\n"
+            << std::defaultfloat;
+
+        if (iteration % settings.validateEvery == 0 || iteration == settings.iterations) {
+            validate(log);
+        }
+        if (!writeCheckpoint()) {
+            log << "Could not write " << checkpointPath() << "\n";
+        }
+    }
+}
+
+uint64_t SPSATuner::validationSeed() const {
+    RngStream stream = RngStream(settings.seed).derive(UINT64_MAX);
+    return stream();
+}
+
+void SPSATuner::validate(std::ostream& log) {
+    double cost = evaluate(theta, validationSeed());
+    bool improved = !haveBest || cost < bestCost;
+    if (improved) {
+        best = theta;
+        bestCost = cost;
+        haveBest = true;
+        if (!writeBest()) {
+            log << "Could not write " << settings.outputPath << "\n";
+        }
+    }
+
+    log << "Validation: " << std::fixed << std::setprecision(3) << cost
+        << (improved ? " (new best, written to " + settings.outputPath + ")" : " (best " + std::to_string(bestCost) + ")")
+        << "\n" << std::defaultfloat;
+    for (size_t i = 0; i < names.size(); i++) {
+        log << "    " << names[i] << " " << theta[i] << "\n";
+    }
+}
+
+std::string SPSATuner::checkpointPath() const {
+    return settings.checkpointPath.empty() ? settings.outputPath + ".checkpoint" : settings.checkpointPath;
+}
+
+// Written to a temporary file and renamed, so an interrupted write
+// leaves the previous checkpoint in place
+bool SPSATuner::writeCheckpoint() const {
+    std::string path = checkpointPath();
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary);
+        if (!out) return false;
+        out << std::setprecision(17);
+        out << "# SPSA checkpoint (seed " << settings.seed << ")\n";
+        out << "iteration " << iteration << "\n";
+        if (haveBest) {
+            out << "best_score " << bestCost << "\n";
+        }
+        for (size_t i = 0; i < names.size(); i++) {
+            out << "theta " << names[i] << " " << theta[i] << "\n";
+        }
+        for (size_t i = 0; i < names.size(); i++) {
+            out << "best " << names[i] << " " << best[i] << "\n";
+        }
+        if (!out) return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool SPSATuner::writeBest() const {
+    std::ofstream out(settings.outputPath);
+    if (!out) return false;
+    out << "# Tuned over " << iteration << " SPSA iterations: " << std::setprecision(6) << bestCost
+        << " on the validation games (" << settings.games << " games)\n";
+    out << std::setprecision(17);
+    for (size_t i = 0; i < names.size(); i++) {
+        out << names[i] << " " << best[i] << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace sevens
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sevens {
+
+// Settings of SPSATuner
+struct TunerConfig {
+    int iterations = 100;
+    uint64_t games = 512;          // games per evaluation of one parameter vector
+    uint64_t seed = 0;
+    double perturbation = 0.1;     // first perturbation, relative to each parameter's scale
+    double stepSize = 0.02;        // first step per unit of gradient, relative to the scale
+    double maxStep = 0.5;          // cap on one step, relative to the scale
+    int validateEvery = 10;        // iterations between two evaluations of the current vector
+    std::string outputPath = "tuned_params.txt";
+    std::string checkpointPath;    // empty = outputPath + ".checkpoint"
+};
+
+/**
+ * Noisy black-box minimization with SPSA (Simultaneous Perturbation
+ * Stochastic Approximation).
+ *
+ * Each iteration perturbs every parameter at once by +-c (random signs)
+ * and evaluates the vector on both sides. Both evaluations play the same
+ * games (same seed), so the luck of the deal cancels out of their
+ * difference. That difference is the gradient estimate along the
+ * perturbation, whatever the number of parameters. Gains decrease with
+ * the usual exponents (0.602 for the step, 0.101 for the perturbation).
+ * Parameters move in units of their starting magnitude, so weights of
+ * different sizes are tuned alike.
+ *
+ * Every `validateEvery` iterations the current vector is evaluated on a
+ * fixed validation seed; the best one seen so far is written to the
+ * output file as a parameter file ("name value" lines). A checkpoint is
+ * written after every iteration. An interrupted run started again with
+ * the same settings resumes from it and makes the same choices, since
+ * iteration k always draws from RngStream(seed).derive(k).
+ *
+ * The objective does the parallel work (GameSimulator), so the tuner
+ * itself is single-threaded.
+ */
+class SPSATuner {
+public:
+    // Mean cost (lower is better) of `values` over games played with `seed`
+    typedef std::function<double(const std::vector<double>& values, uint64_t seed)> Objective;
+
+    SPSATuner(const TunerConfig& config, std::vector<std::string> parameterNames,
+              std::vector<double> initialValues, Objective objective);
+
+    // Continue from the checkpoint file if there is one; false (with
+    // `error` set) if it exists but does not match these parameters
+    bool resume(std::string& error);
+
+    // Run the remaining iterations, reporting progress to `log`
+    void run(std::ostream& log);
+
+    const std::vector<double>& bestValues() const { return best; }
+    double bestScore() const { return bestCost; }
+
+private:
+    TunerConfig settings;
+    std::vector<std::string> names;
+    std::vector<double> theta;
+    std::vector<double> scale;
+    std::vector<double> best;
+    double bestCost = 0.0;
+    bool haveBest = false;
+    int iteration = 0;
+    Objective evaluate;
+
+    uint64_t validationSeed() const;
+    void validate(std::ostream& log);
+    std::string checkpointPath() const;
+    bool writeCheckpoint() const;
+    bool writeBest() const;
+};
+
+} // namespace sevens
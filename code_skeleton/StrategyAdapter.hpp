@@ -0,0 +1,94 @@
+#pragma once
+
+#include "PlayerStrategy.hpp"
+#include "PlayerStrategyV2.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Runs a version 1 PlayerStrategy behind the version 2 interface.
+ * The hand vector and the nested-map table the old interface expects are
+ * kept in scratch members and only updated for what changed since the
+ * previous call. The hand is in deal order, as the version 1 interface
+ * has always handed it out, once the engine has passed the deal order.
+ */
+class LegacyStrategyAdapter : public PlayerStrategyV2, public SeededStrategy, public DealOrderStrategy {
+public:
+    explicit LegacyStrategyAdapter(std::shared_ptr<PlayerStrategy> strategy)
+        : inner(std::move(strategy)) {}
+
+    void initialize(uint64_t playerID) override {
+        inner->initialize(playerID);
+    }
+
+    int selectCard(GameView view) override {
+        if (dealOrder) {
+            handView.clear();
+            for (size_t i = 0; i < dealCount; i++) {
+                if (view.hand >> dealOrder[i] & 1) {
+                    handView.push_back(bitboard::cardAt(dealOrder[i]));
+                }
+            }
+        } else {
+            bitboard::toCards(view.hand, handView);
+        }
+        bitboard::syncTableLayout(view.table, layoutBits, layout);
+
+        int index = inner->selectCardToPlay(handView, layout);
+        if (index < 0 || index >= static_cast<int>(handView.size())) {
+            return -1;
+        }
+        return bitboard::cardBit(handView[index].suit, handView[index].rank);
+    }
+
+    void observeMove(uint64_t playerID, const Card& playedCard) override {
+        inner->observeMove(playerID, playedCard);
+    }
+
+    void observePass(uint64_t playerID) override {
+        inner->observePass(playerID);
+    }
+
+    std::string getName() const override {
+        return inner->getName();
+    }
+
+    void seedRandom(const RngStream& stream) override {
+        if (auto* seeded = dynamic_cast<SeededStrategy*>(inner.get())) {
+            seeded->seedRandom(stream);
+        }
+    }
+
+    void setDealOrder(const uint8_t* cards, size_t count) override {
+        dealOrder = cards;
+        dealCount = count;
+    }
+
+private:
+    std::shared_ptr<PlayerStrategy> inner;
+    std::vector<Card> handView;
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, bool>> layout;
+    CardMask layoutBits = 0;
+    const uint8_t* dealOrder = nullptr;
+    size_t dealCount = 0;
+};
+
+/**
+ * View any strategy through the version 2 interface: classes implementing
+ * both interfaces are used directly, others are wrapped in the adapter.
+ */
+inline std::shared_ptr<PlayerStrategyV2> asStrategyV2(const std::shared_ptr<PlayerStrategy>& strategy) {
+    if (!strategy) {
+        return nullptr;
+    }
+    if (auto* v2 = dynamic_cast<PlayerStrategyV2*>(strategy.get())) {
+        // Share ownership with the original pointer
+        return std::shared_ptr<PlayerStrategyV2>(strategy, v2);
+    }
+    return std::make_shared<LegacyStrategyAdapter>(strategy);
+}
+
+} // namespace sevens
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "PlayerStrategyV2.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace sevens {
+
+/**
+ * How much a seat may think per move. Only strategies implementing
+ * AnytimeStrategy are given a budget; the others are called as usual.
+ *
+ *   moveSeconds        the same time for every move
+ *   bankSeconds        a time bank per game, spread over the moves; every
+ *   incrementSeconds   move adds the increment back to the bank
+ *   moveNodes          a number of work units per move
+ *
+ * Fields can be combined (the tighter limit wins); all zero is no time
+ * control.
+ */
+struct TimeControl {
+    double moveSeconds = 0.0;
+    double bankSeconds = 0.0;
+    double incrementSeconds = 0.0;
+    uint64_t moveNodes = 0;
+
+    // A game has many rounds, so the bank is spread over the cards in
+    // hand plus this many moves kept in reserve for later rounds
+    static const int BANK_RESERVE_MOVES = 20;
+
+    bool active() const {
+        return moveSeconds > 0 || bankSeconds > 0 || moveNodes > 0;
+    }
+
+    // Budget for the next move, with `bankLeft` seconds in the bank and
+    // `handSize` cards in hand
+    SearchBudget budget(double bankLeft, int handSize) const {
+        double seconds = moveSeconds;
+        if (bankSeconds > 0) {
+            double share = bankLeft / (handSize + BANK_RESERVE_MOVES) + incrementSeconds;
+            if (seconds <= 0 || share < seconds) {
+                seconds = share;
+            }
+        }
+
+        SearchBudget result;
+        if (seconds > 0 || bankSeconds > 0) {
+            result = SearchBudget::within(seconds);
+        }
+        result.nodes = moveNodes;
+        return result;
+    }
+
+    /**
+     * Parse a comma-separated list of limits (times in milliseconds):
+     *   move:50          50 ms per move
+     *   bank:10000+100   a 10 s bank per game, plus 100 ms per move
+     *   nodes:5000       5000 work units per move
+     * Returns false if the spec is malformed.
+     */
+    static bool parse(const std::string& spec, TimeControl& out) {
+        TimeControl control;
+        std::stringstream items(spec);
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            size_t colon = item.find(':');
+            if (colon == std::string::npos) return false;
+            std::string key = item.substr(0, colon);
+            const char* value = item.c_str() + colon + 1;
+            char* end = nullptr;
+
+            if (key == "move") {
+                control.moveSeconds = std::strtod(value, &end) / 1000.0;
+            } else if (key == "bank") {
+                control.bankSeconds = std::strtod(value, &end) / 1000.0;
+                if (*end == '+') {
+                    control.incrementSeconds = std::strtod(end + 1, &end) / 1000.0;
+                }
+            } else if (key == "nodes") {
+                control.moveNodes = std::strtoull(value, &end, 10);
+            } else {
+                return false;
+            }
+            if (end == value || *end != '\0') return false;
+        }
+        if (!control.active()) return false;
+        out = control;
+        return true;
+    }
+};
+
+} // namespace sevens
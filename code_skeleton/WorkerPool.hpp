@@ -0,0 +1,106 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sevens {
+
+/**
+ * Fixed set of threads that run one job at a time.
+ *
+ * run(job) calls job(worker) once on every worker, 0 being the calling
+ * thread itself, and returns when all calls have returned. The threads
+ * are started once and sleep between jobs, so a strategy can hand out
+ * work on every decision without creating threads or allocating: the job
+ * is passed by reference and called through a plain function pointer.
+ * Splitting the work between the workers is up to the job (typically an
+ * atomic counter of work items).
+ */
+class WorkerPool {
+public:
+    // `threads` workers in total, including the caller of run()
+    explicit WorkerPool(unsigned threads) {
+        for (unsigned index = 1; index < threads; index++) {
+            helpers.emplace_back([this, index] { helperLoop(index); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& helper : helpers) {
+            helper.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned size() const {
+        return static_cast<unsigned>(helpers.size()) + 1;
+    }
+
+    template <typename Job>
+    void run(Job& job) {
+        if (helpers.empty()) {
+            job(0u);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            context = &job;
+            call = [](void* target, unsigned worker) { (*static_cast<Job*>(target))(worker); };
+            running = static_cast<unsigned>(helpers.size());
+            generation++;
+        }
+        wake.notify_all();
+
+        job(0u);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return running == 0; });
+    }
+
+private:
+    void helperLoop(unsigned index) {
+        uint64_t seen = 0;
+        for (;;) {
+            void* target;
+            void (*function)(void*, unsigned);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                target = context;
+                function = call;
+            }
+
+            function(target, index);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> helpers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation = 0;
+    unsigned running = 0;
+    bool stopping = false;
+    void* context = nullptr;
+    void (*call)(void*, unsigned) = nullptr;
+};
+
+} // namespace sevens
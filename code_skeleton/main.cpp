@@ -9,6 +9,16 @@
 #include "RandomStrategy.hpp"
 #include "GreedyStrategy.hpp"
 #include "StrategyLoader.hpp"
+#include "GameSimulator.hpp"
+#include "StrategyAdapter.hpp"
+#include "TimeControl.hpp"
+#include "SPSATuner.hpp"
+#include "League.hpp"
+#include "SPRT.hpp"
+#include "GameArchive.hpp"
+#include "GameRecord.hpp"
+#include <algorithm>
+#include <sstream>
 // Windows-specific includes for dynamic loading
 
 // For dynamic loading - platform-specific headers
@@ -23,7 +33,9 @@
 using namespace sevens;
 
 // Function to load a strategy from a shared library (DLL on Windows)
-std::shared_ptr<PlayerStrategy> loadStrategyFromLibrary(const std::string& libraryPath) {
+// Prefers the version 2 interface (createStrategyV2); libraries that only
+// export createStrategy are run through LegacyStrategyAdapter.
+std::shared_ptr<PlayerStrategyV2> loadStrategyFromLibrary(const std::string& libraryPath) {
 #ifdef _WIN32
     // Windows version
     HMODULE handle = LoadLibraryA(libraryPath.c_str());
@@ -32,9 +44,24 @@ std::shared_ptr<PlayerStrategy> loadStrategyFromLibrary(const std::string& libra
         return nullptr;
     }
     
-    // Load the createStrategy function
-    typedef PlayerStrategy* (*CreateStrategyFn)();
+    // Look for the version 2 factory first
     // First cast to void* to avoid the function type warning
+    void* procAddressV2 = (void*)GetProcAddress(handle, "createStrategyV2");
+    if (procAddressV2) {
+        CreateStrategyV2Fn createStrategyV2 = reinterpret_cast<CreateStrategyV2Fn>(procAddressV2);
+        PlayerStrategyV2* strategy = createStrategyV2();
+        if (!strategy) {
+            std::cerr << "Failed to create strategy instance" << std::endl;
+            FreeLibrary(handle);
+            return nullptr;
+        }
+        return std::shared_ptr<PlayerStrategyV2>(strategy, [handle](PlayerStrategyV2* p) {
+            delete p;
+            FreeLibrary(handle);
+        });
+    }
+    
+    // Load the createStrategy function
     void* procAddress = (void*)GetProcAddress(handle, "createStrategy");
     // Then cast to the actual function type
     CreateStrategyFn createStrategy = reinterpret_cast<CreateStrategyFn>(procAddress);
@@ -53,10 +80,11 @@ std::shared_ptr<PlayerStrategy> loadStrategyFromLibrary(const std::string& libra
     }
     
     // Wrap the raw pointer in a shared_ptr with custom deleter
-    return std::shared_ptr<PlayerStrategy>(strategy, [handle](PlayerStrategy* p) {
-        delete p;
-        FreeLibrary(handle);
-    });
+    return std::make_shared<LegacyStrategyAdapter>(
+        std::shared_ptr<PlayerStrategy>(strategy, [handle](PlayerStrategy* p) {
+            delete p;
+            FreeLibrary(handle);
+        }));
 #else
     // Linux/Unix version (same as before)
     void* handle = dlopen(libraryPath.c_str(), RTLD_LAZY);
@@ -65,11 +93,25 @@ std::shared_ptr<PlayerStrategy> loadStrategyFromLibrary(const std::string& libra
         return nullptr;
     }
     
+    // Look for the version 2 factory first
+    CreateStrategyV2Fn createStrategyV2 = (CreateStrategyV2Fn)dlsym(handle, "createStrategyV2");
+    if (createStrategyV2) {
+        PlayerStrategyV2* strategy = createStrategyV2();
+        if (!strategy) {
+            std::cerr << "Failed to create strategy instance" << std::endl;
+            dlclose(handle);
+            return nullptr;
+        }
+        return std::shared_ptr<PlayerStrategyV2>(strategy, [handle](PlayerStrategyV2* p) {
+            delete p;
+            dlclose(handle);
+        });
+    }
+    
     // Clear any existing error
     dlerror();
     
     // Load the createStrategy function
-    typedef PlayerStrategy* (*CreateStrategyFn)();
     CreateStrategyFn createStrategy = (CreateStrategyFn)dlsym(handle, "createStrategy");
     const char* dlsym_error = dlerror();
     if (dlsym_error) {
@@ -87,20 +129,133 @@ std::shared_ptr<PlayerStrategy> loadStrategyFromLibrary(const std::string& libra
     }
     
     // Wrap the raw pointer in a shared_ptr with custom deleter
-    return std::shared_ptr<PlayerStrategy>(strategy, [handle](PlayerStrategy* p) {
-        delete p;
-        dlclose(handle);
-    });
+    return std::make_shared<LegacyStrategyAdapter>(
+        std::shared_ptr<PlayerStrategy>(strategy, [handle](PlayerStrategy* p) {
+            delete p;
+            dlclose(handle);
+        }));
 #endif
 }
 
+// Build a factory for a strategy given on the command line:
+// "random", "greedy" or the path of a strategy library
+StrategyFactory makeStrategyFactory(const std::string& spec) {
+    if (spec == "random") {
+        return [] { return std::make_shared<RandomStrategy>(); };
+    }
+    if (spec == "greedy") {
+        return [] { return std::make_shared<GreedyStrategy>(); };
+    }
+    
+    // Check the library once up front so a bad path fails early
+    if (!loadStrategyFromLibrary(spec)) {
+        return nullptr;
+    }
+    return [spec] { return loadStrategyFromLibrary(spec); };
+}
+
+// A "--time <seat|all> <spec>" option (seat -1 = every seat)
+struct TimeOption {
+    int seat;
+    TimeControl control;
+};
+
+bool parseTimeOption(const std::string& seat, const std::string& spec, TimeOption& out) {
+    if (seat == "all") {
+        out.seat = -1;
+    } else if (!seat.empty() && seat.find_first_not_of("0123456789") == std::string::npos) {
+        out.seat = std::stoi(seat);
+    } else {
+        return false;
+    }
+    return TimeControl::parse(spec, out.control);
+}
+
+// Give the time controls to the first `numSeats` seats
+void applyTimeOptions(MyGameMapper& gameMapper, const std::vector<TimeOption>& options, uint64_t numSeats) {
+    for (const TimeOption& option : options) {
+        for (uint64_t seat = 0; seat < numSeats; seat++) {
+            if (option.seat < 0 || static_cast<uint64_t>(option.seat) == seat) {
+                gameMapper.setTimeControl(seat, option.control);
+            }
+        }
+    }
+}
+
+// Short name of a card bit, such as "QH" or "TC"
+std::string shortCardName(int bit) {
+    Card card = bitboard::cardAt(bit);
+    std::string name;
+    name += "?A23456789TJQK"[card.rank];
+    name += "CDHS"[card.suit];
+    return name;
+}
+
+std::string shortHandName(CardMask hand) {
+    std::string names;
+    bitboard::forEachCard(hand, [&](int bit) {
+        names += names.empty() ? "" : " ";
+        names += shortCardName(bit);
+    });
+    return names;
+}
+
+// Replay a recorded game: hands dealt, turns and cards left every round
+void printRecordedGame(const RecordedGame& game, std::ostream& os) {
+    std::vector<uint64_t> totals(game.numSeats, 0);
+    for (size_t r = 0; r < game.rounds.size(); r++) {
+        const RecordedRound& round = game.rounds[r];
+        std::vector<CardMask> hands = round.hands;
+        os << "Round " << r + 1 << "\n";
+        for (uint64_t seat = 0; seat < game.numSeats; seat++) {
+            os << "    Player " << seat << " dealt: " << shortHandName(hands[seat]) << "\n";
+        }
+        
+        os << "    Turns:";
+        for (size_t turn = 0; turn < round.moves.size(); turn++) {
+            uint8_t move = round.moves[turn];
+            if (move == records::PASS) {
+                os << " -";
+            } else {
+                hands[turn % game.numSeats] &= ~(CardMask(1) << move);
+                os << " " << shortCardName(move);
+            }
+        }
+        os << "\n    Cards left:";
+        for (uint64_t seat = 0; seat < game.numSeats; seat++) {
+            uint64_t left = bitboard::popcount(hands[seat]);
+            totals[seat] += left;
+            os << " " << left;
+        }
+        os << "\n";
+    }
+    
+    os << "Totals:";
+    for (uint64_t total : totals) {
+        os << " " << total;
+    }
+    os << "\n";
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         std::cout << "Usage: ./sevens_game [mode] [optional libs...]\n";
         std::cout << "  Modes:\n";
         std::cout << "    internal - Run with default random strategies\n";
         std::cout << "    demo - Run with built-in strategies\n";
-        std::cout << "    competition - Load strategies from .so/.dll files\n";
+        std::cout << "    competition [--time <seat|all> <spec>] <libs...> - Load strategies from .so/.dll files\n";
+        std::cout << "    simulate <games> <seed> [--threads N] [--time <seat|all> <spec>] [--record FILE] <strategies...> - Headless batch of games\n";
+        std::cout << "        (strategy = random, greedy or a .so/.dll file)\n";
+        std::cout << "        (spec = move:MS, bank:MS+INC and/or nodes:N, comma-separated)\n";
+        std::cout << "    tune <iterations> <games> <seed> [--threads N] [--out FILE] [--checkpoint FILE] [--validate K] <tuned> <opponents...>\n";
+        std::cout << "        - SPSA tuning of the first strategy's weights against the others\n";
+        std::cout << "    league <games> <seed> [--threads N] [--players 2,3,4] [--state FILE] <strategies...>\n";
+        std::cout << "        - Every table of the pool in every seat order, rated with Bradley-Terry\n";
+        std::cout << "    sprt <seed> [--elo0 E] [--elo1 E] [--alpha P] [--beta P] [--max-pairs N] [--batch N] [--threads N] <A> <B> [others...]\n";
+        std::cout << "        - Paired A/B games until a sequential test decides whether A beats B\n";
+        std::cout << "    duplicate <deals> <seed> [--threads N] <strategies...>\n";
+        std::cout << "        - Every deal replayed in every seat order, scored against the field\n";
+        std::cout << "    replay <archive> <game> - Print a game recorded with simulate --record FILE\n";
         return 1;
     }
     
@@ -172,9 +327,20 @@ int main(int argc, char* argv[]) {
         std::cout << "Running in competition mode with dynamic strategies\n";
         
         // Load strategies from shared libraries
-        std::vector<std::shared_ptr<PlayerStrategy>> strategies;
+        std::vector<std::shared_ptr<PlayerStrategyV2>> strategies;
+        std::vector<TimeOption> timeOptions;
         for (int i = 2; i < argc; i++) {
-            std::shared_ptr<PlayerStrategy> strategy = loadStrategyFromLibrary(argv[i]);
+            if (std::string(argv[i]) == "--time") {
+                TimeOption option;
+                if (i + 2 >= argc || !parseTimeOption(argv[i + 1], argv[i + 2], option)) {
+                    std::cout << "Expected --time <seat|all> <spec>\n";
+                    return 1;
+                }
+                timeOptions.push_back(option);
+                i += 2;
+                continue;
+            }
+            std::shared_ptr<PlayerStrategyV2> strategy = loadStrategyFromLibrary(argv[i]);
             if (strategy) {
                 strategies.push_back(strategy);
                 std::cout << "Loaded strategy: " << strategy->getName() << " from " << argv[i] << "\n";
@@ -188,8 +354,9 @@ int main(int argc, char* argv[]) {
         
         // Register strategies with the game
         for (uint64_t i = 0; i < strategies.size(); i++) {
-            gameMapper.registerStrategy(i, strategies[i]);
+            gameMapper.registerStrategyV2(i, strategies[i]);
         }
+        applyTimeOptions(gameMapper, timeOptions, strategies.size());
         
         // Run the game
         auto results = gameMapper.compute_and_display_game(strategies.size());
@@ -202,6 +369,346 @@ int main(int argc, char* argv[]) {
             }
         }
     }
+    else if (mode == "simulate") {
+        if (argc < 6) {
+            std::cout << "Usage: ./sevens_game simulate <games> <seed> [--threads N] [--time <seat|all> <spec>] [--record FILE] strategy1 strategy2 [...]\n";
+            return 1;
+        }
+        
+        uint64_t numGames = std::stoull(argv[2]);
+        uint64_t seed = std::stoull(argv[3]);
+        
+        unsigned numThreads = 0; // all cores
+        
+        std::vector<StrategyFactory> factories;
+        std::vector<TimeOption> timeOptions;
+        std::string recordPath;
+        std::string seats;
+        for (int i = 4; i < argc; i++) {
+            if (std::string(argv[i]) == "--threads" && i + 1 < argc) {
+                numThreads = static_cast<unsigned>(std::stoul(argv[++i]));
+                continue;
+            }
+            if (std::string(argv[i]) == "--record" && i + 1 < argc) {
+                recordPath = argv[++i];
+                continue;
+            }
+            if (std::string(argv[i]) == "--time") {
+                TimeOption option;
+                if (i + 2 >= argc || !parseTimeOption(argv[i + 1], argv[i + 2], option)) {
+                    std::cout << "Expected --time <seat|all> <spec>\n";
+                    return 1;
+                }
+                timeOptions.push_back(option);
+                i += 2;
+                continue;
+            }
+            StrategyFactory factory = makeStrategyFactory(argv[i]);
+            if (!factory) {
+                std::cout << "Could not load strategy: " << argv[i] << "\n";
+                return 1;
+            }
+            seats += (seats.empty() ? "" : ", ") + std::string("seat ") + std::to_string(factories.size()) + ": " + argv[i];
+            factories.push_back(factory);
+        }
+        if (factories.size() < 2) {
+            std::cout << "Need at least two strategies\n";
+            return 1;
+        }
+        
+        std::cout << "Simulating " << numGames << " games with seed " << seed << "\n";
+        
+        // The simulator copies the engine, time controls included
+        applyTimeOptions(gameMapper, timeOptions, factories.size());
+        GameSimulator simulator(gameMapper, factories);
+        
+        GameArchiveWriter archive;
+        std::string error;
+        if (!recordPath.empty()) {
+            if (!archive.open(recordPath, seats + " (seed " + std::to_string(seed) + ")", error)) {
+                std::cout << error << "\n";
+                return 1;
+            }
+            simulator.setArchive(&archive);
+        }
+        
+        SimulationStats stats = simulator.run(numGames, seed, numThreads);
+        GameSimulator::printStats(stats, std::cout);
+        
+        if (!recordPath.empty()) {
+            if (!archive.close(error)) {
+                std::cout << error << "\n";
+                return 1;
+            }
+            std::cout << "Recorded " << archive.games() << " games in " << recordPath << ": "
+                      << archive.fileBytes() << " bytes (" << archive.rawBytes() << " before compression)\n";
+        }
+    }
+    else if (mode == "tune") {
+        if (argc < 7) {
+            std::cout << "Usage: ./sevens_game tune <iterations> <games> <seed> [--threads N] [--out FILE] [--checkpoint FILE] [--validate K] tuned opponent1 [...]\n";
+            return 1;
+        }
+        
+        TunerConfig config;
+        config.iterations = std::stoi(argv[2]);
+        config.games = std::stoull(argv[3]);
+        config.seed = std::stoull(argv[4]);
+        unsigned numThreads = 0; // all cores
+        
+        std::vector<StrategyFactory> factories;
+        for (int i = 5; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                numThreads = static_cast<unsigned>(std::stoul(argv[++i]));
+                continue;
+            }
+            if (arg == "--out" && i + 1 < argc) {
+                config.outputPath = argv[++i];
+                continue;
+            }
+            if (arg == "--validate" && i + 1 < argc) {
+                config.validateEvery = std::stoi(argv[++i]);
+                continue;
+            }
+            if (arg == "--checkpoint" && i + 1 < argc) {
+                config.checkpointPath = argv[++i];
+                continue;
+            }
+            StrategyFactory factory = makeStrategyFactory(arg);
+            if (!factory) {
+                std::cout << "Could not load strategy: " << arg << "\n";
+                return 1;
+            }
+            factories.push_back(factory);
+        }
+        if (factories.size() < 2) {
+            std::cout << "Need the strategy to tune and at least one opponent\n";
+            return 1;
+        }
+        
+        // The starting point is the tuned strategy's current weights
+        // (its defaults, or its own parameter file)
+        std::shared_ptr<PlayerStrategyV2> sample = factories[0]();
+        TunableStrategy* tunable = dynamic_cast<TunableStrategy*>(sample.get());
+        if (!tunable) {
+            std::cout << sample->getName() << " has no tunable parameters\n";
+            return 1;
+        }
+        std::vector<std::string> names;
+        std::vector<double> initial;
+        for (int i = 0; i < tunable->parameterCount(); i++) {
+            names.push_back(tunable->parameterName(i));
+            initial.push_back(tunable->getParameter(i));
+        }
+        
+        // Cost of a weight vector: cards left per game by seat 0, over a
+        // batch of games played on all threads
+        StrategyFactory base = factories[0];
+        auto objective = [&](const std::vector<double>& values, uint64_t gameSeed) {
+            std::vector<StrategyFactory> seats = factories;
+            seats[0] = [base, values] {
+                std::shared_ptr<PlayerStrategyV2> strategy = base();
+                TunableStrategy* weights = dynamic_cast<TunableStrategy*>(strategy.get());
+                for (size_t i = 0; i < values.size(); i++) {
+                    weights->setParameter(static_cast<int>(i), values[i]);
+                }
+                return strategy;
+            };
+            GameSimulator simulator(gameMapper, seats);
+            SimulationStats stats = simulator.run(config.games, gameSeed, numThreads);
+            return static_cast<double>(stats.cardsLeft[0]) / stats.games;
+        };
+        
+        std::cout << "Tuning " << names.size() << " parameters of " << sample->getName()
+                  << " over " << config.iterations << " iterations of 2 x " << config.games << " games\n";
+        
+        SPSATuner tuner(config, names, initial, objective);
+        std::string error;
+        if (!tuner.resume(error)) {
+            std::cout << error << "\n";
+            return 1;
+        }
+        tuner.run(std::cout);
+        std::cout << "Best: " << tuner.bestScore() << " cards per game, written to " << config.outputPath << "\n";
+    }
+    else if (mode == "league") {
+        if (argc < 6) {
+            std::cout << "Usage: ./sevens_game league <games> <seed> [--threads N] [--players 2,3,4] [--state FILE] strategy1 strategy2 [...]\n";
+            return 1;
+        }
+        
+        LeagueConfig config;
+        config.gamesPerTable = std::stoull(argv[2]);
+        config.seed = std::stoull(argv[3]);
+        
+        std::vector<std::string> specs;
+        std::vector<StrategyFactory> factories;
+        for (int i = 4; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+                continue;
+            }
+            if (arg == "--players" && i + 1 < argc) {
+                std::stringstream counts(argv[++i]);
+                std::string count;
+                while (std::getline(counts, count, ',')) {
+                    config.playerCounts.push_back(std::stoi(count));
+                }
+                continue;
+            }
+            if (arg == "--state" && i + 1 < argc) {
+                config.statePath = argv[++i];
+                continue;
+            }
+            if (std::find(specs.begin(), specs.end(), arg) != specs.end()) {
+                std::cout << "Strategy listed twice: " << arg << "\n";
+                return 1;
+            }
+            StrategyFactory factory = makeStrategyFactory(arg);
+            if (!factory) {
+                std::cout << "Could not load strategy: " << arg << "\n";
+                return 1;
+            }
+            specs.push_back(arg);
+            factories.push_back(factory);
+        }
+        if (specs.size() < 2) {
+            std::cout << "A league needs at least two strategies\n";
+            return 1;
+        }
+        
+        League league(gameMapper, specs, factories, config);
+        std::string error;
+        if (!league.loadState(error)) {
+            std::cout << error << "\n";
+            return 1;
+        }
+        league.run(std::cout);
+        League::printRatings(league.ratings(), std::cout);
+    }
+    else if (mode == "sprt") {
+        if (argc < 5) {
+            std::cout << "Usage: ./sevens_game sprt <seed> [--elo0 E] [--elo1 E] [--alpha P] [--beta P] [--max-pairs N] [--batch N] [--threads N] A B [others...]\n";
+            return 1;
+        }
+        
+        SPRTConfig config;
+        config.seed = std::stoull(argv[2]);
+        
+        std::vector<StrategyFactory> factories;
+        std::vector<std::string> specs;
+        for (int i = 3; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--elo0" && hasValue) {
+                config.elo0 = std::stod(argv[++i]);
+            } else if (arg == "--elo1" && hasValue) {
+                config.elo1 = std::stod(argv[++i]);
+            } else if (arg == "--alpha" && hasValue) {
+                config.alpha = std::stod(argv[++i]);
+            } else if (arg == "--beta" && hasValue) {
+                config.beta = std::stod(argv[++i]);
+            } else if (arg == "--max-pairs" && hasValue) {
+                config.maxPairs = std::stoull(argv[++i]);
+            } else if (arg == "--batch" && hasValue) {
+                config.batchPairs = std::stoull(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else {
+                StrategyFactory factory = makeStrategyFactory(arg);
+                if (!factory) {
+                    std::cout << "Could not load strategy: " << arg << "\n";
+                    return 1;
+                }
+                factories.push_back(factory);
+                specs.push_back(arg);
+            }
+        }
+        if (factories.size() < 2) {
+            std::cout << "Need strategies A and B\n";
+            return 1;
+        }
+        if (config.elo1 <= config.elo0 || config.alpha <= 0 || config.alpha >= 1 || config.beta <= 0 || config.beta >= 1) {
+            std::cout << "Need elo0 < elo1 and alpha, beta between 0 and 1\n";
+            return 1;
+        }
+        
+        std::cout << "A = " << specs[0] << ", B = " << specs[1] << "\n";
+        std::vector<StrategyFactory> others(factories.begin() + 2, factories.end());
+        ABMatch match(gameMapper, factories[0], factories[1], others, config);
+        SPRT::Result result = match.run(std::cout);
+        return result == SPRT::ACCEPT_H1 ? 0 : result == SPRT::ACCEPT_H0 ? 2 : 3;
+    }
+    else if (mode == "duplicate") {
+        if (argc < 6) {
+            std::cout << "Usage: ./sevens_game duplicate <deals> <seed> [--threads N] strategy1 strategy2 [...]\n";
+            return 1;
+        }
+        
+        uint64_t numDeals = std::stoull(argv[2]);
+        uint64_t seed = std::stoull(argv[3]);
+        if (numDeals < 2) {
+            std::cout << "Need at least two deals for duplicate scores\n";
+            return 1;
+        }
+        
+        unsigned numThreads = 0; // all cores
+        
+        std::vector<StrategyFactory> factories;
+        for (int i = 4; i < argc; i++) {
+            if (std::string(argv[i]) == "--threads" && i + 1 < argc) {
+                numThreads = static_cast<unsigned>(std::stoul(argv[++i]));
+                continue;
+            }
+            StrategyFactory factory = makeStrategyFactory(argv[i]);
+            if (!factory) {
+                std::cout << "Could not load strategy: " << argv[i] << "\n";
+                return 1;
+            }
+            factories.push_back(factory);
+        }
+        if (factories.size() < 2) {
+            std::cout << "Need at least two strategies\n";
+            return 1;
+        }
+        
+        GameSimulator simulator(gameMapper, factories);
+        std::cout << "Replaying " << numDeals << " deals in " << simulator.seatOrders()
+                  << " seat orders with seed " << seed << "\n";
+        
+        std::vector<uint64_t> gameCards;
+        SimulationStats stats = simulator.runDuplicate(numDeals, seed, numThreads, &gameCards);
+        GameSimulator::printStats(stats, std::cout);
+        GameSimulator::printDuplicate(stats, gameCards, simulator.seatOrders(), std::cout);
+    }
+    else if (mode == "replay") {
+        if (argc < 4) {
+            std::cout << "Usage: ./sevens_game replay <archive> <game>\n";
+            return 1;
+        }
+        
+        uint64_t game = std::stoull(argv[3]);
+        GameArchiveReader archive;
+        std::string error;
+        std::vector<uint8_t> bytes;
+        if (!archive.open(argv[2], error) || !archive.find(game, bytes, error)) {
+            std::cout << error << "\n";
+            return 1;
+        }
+        
+        RecordedGame record;
+        if (!decodeGame(bytes.data(), bytes.size(), record)) {
+            std::cout << "Game " << game << " is damaged\n";
+            return 1;
+        }
+        std::cout << argv[2] << ": " << archive.games() << " games in " << archive.blockCount()
+                  << " blocks, " << archive.description() << "\n";
+        std::cout << "Game " << game << ": " << record.numSeats << " players, "
+                  << record.rounds.size() << " rounds, " << bytes.size() << " bytes\n";
+        printRecordedGame(record, std::cout);
+    }
     else {
         std::cerr << "Unknown mode: " << mode << std::endl;
         return 1;
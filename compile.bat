@@ -1,14 +1,35 @@
 @echo off
 echo Compiling Sevens Game...
-g++ -std=c++17 -Wall -Wextra -Werror -pedantic -pedantic-errors -O3 ^
+g++ -std=c++17 -Wall -Wextra -Werror -pedantic -pedantic-errors -O3 -pthread ^
 code_skeleton\MyCardParser.cpp ^
 code_skeleton\MyGameParser.cpp ^
 code_skeleton\MyGameMapper.cpp ^
 code_skeleton\RandomStrategy.cpp ^
 code_skeleton\GreedyStrategy.cpp ^
+code_skeleton\GameSimulator.cpp ^
+code_skeleton\SPSATuner.cpp ^
+code_skeleton\League.cpp ^
+code_skeleton\SPRT.cpp ^
+code_skeleton\GameArchive.cpp ^
 code_skeleton\main.cpp ^
 -o sevens_game.exe
 
+echo.
+echo Compiling benchmarks...
+g++ -std=c++17 -Wall -Wextra -Werror -pedantic -pedantic-errors -O3 -pthread -DSEVENS_COUNT_ALLOCATIONS ^
+code_skeleton\MyCardParser.cpp ^
+code_skeleton\MyGameParser.cpp ^
+code_skeleton\MyGameMapper.cpp ^
+code_skeleton\RandomStrategy.cpp ^
+code_skeleton\GreedyStrategy.cpp ^
+code_skeleton\FYM_Quest.cpp ^
+code_skeleton\EndgameSolver.cpp ^
+code_skeleton\PIMCStrategy.cpp ^
+code_skeleton\ISMCTSStrategy.cpp ^
+code_skeleton\AllocationCounter.cpp ^
+code_skeleton\Benchmark.cpp ^
+-o sevens_bench.exe
+
 echo.
 echo Compiling RandomStrategy DLL...
 g++ -std=c++17 -Wall -Wextra -O3 -shared -fPIC -DBUILD_SHARED_LIB code_skeleton\RandomStrategy.cpp -o testing\random_strategy.dll
@@ -19,7 +40,15 @@ g++ -std=c++17 -Wall -Wextra -O3 -shared -fPIC -DBUILD_SHARED_LIB code_skeleton\
 
 echo.
 echo Compiling FYM_Quest DLL...
-g++ -std=c++17 -Wall -Wextra -O3 -shared -fPIC -DBUILD_SHARED_LIB code_skeleton\FYM_Quest.cpp -o FYM_Quest.dll
+g++ -std=c++17 -Wall -Wextra -O3 -shared -fPIC -pthread -DBUILD_SHARED_LIB code_skeleton\FYM_Quest.cpp code_skeleton\EndgameSolver.cpp -o FYM_Quest.dll
+
+echo.
+echo Compiling PIMCStrategy DLL...
+g++ -std=c++17 -Wall -Wextra -O3 -shared -fPIC -pthread -DBUILD_SHARED_LIB code_skeleton\PIMCStrategy.cpp -o testing\pimc_strategy.dll
+
+echo.
+echo Compiling ISMCTSStrategy DLL...
+g++ -std=c++17 -Wall -Wextra -O3 -shared -fPIC -DBUILD_SHARED_LIB code_skeleton\ISMCTSStrategy.cpp -o testing\ismcts_strategy.dll
 
 echo.
 echo Done!
\ No newline at end of file